@@ -0,0 +1,87 @@
+#include "reference_pipeline.hpp"
+#include "utility/imumaths.h"
+
+static constexpr double REF_QUAT_SCALE = 1.0 / (1 << 14);
+static constexpr int REF_SLOWMO_ANGLE_DEFLECTION[6] = {300, 440, 580, 580, 720, 860};   // Original band limits
+
+/************************************************************
+ * @brief Jitter, slow-motion and sensitivity scaling of one axis
+ *        as done by the original pipeline.
+ *************************************************************/
+int ReferencePipeline::_scaleAxis(int64_t change, devSensitivity sensitivity, int32_t sensitivity_level){
+    int move = 0;
+
+    if((change >= -JITTER_OFFSET) && (change <= JITTER_OFFSET)){
+        move = 0;
+    }
+    else if((change >= -SLOW_MOTION_OFFSET) && (change <= SLOW_MOTION_OFFSET)){
+        for(int i=0; i<(int)SENSITIVITY_STEP_COUNT; i++){
+            if((change > REF_SLOWMO_ANGLE_DEFLECTION[i]) && (change <= REF_SLOWMO_ANGLE_DEFLECTION[i+1])){
+                move = (int)((change * SLOWMO_SENSITIVITY[i][sensitivity_level]) / 20000);
+                break;
+            }
+            else if((change > -REF_SLOWMO_ANGLE_DEFLECTION[i+1]) && (change <= -REF_SLOWMO_ANGLE_DEFLECTION[i])){
+                move = (int)((change * SLOWMO_SENSITIVITY[i][sensitivity_level]) / 20000);
+                break;
+            }
+        }
+    }
+    else{
+        move = (int)((change * sensitivity) / 20000);
+    }
+    return move;
+}
+
+/************************************************************
+ * @brief Process one sample with the original pipeline.
+ *
+ * @param sample Raw quaternion sample.
+ * @param sensitivity Active sensitivity (one of PREF_SENSITIVITY).
+ * @param move_x Output: mouse X counts (before HID conversion).
+ * @param move_y Output: mouse Y counts (before HID conversion).
+ *************************************************************/
+void ReferencePipeline::update(const TraceSample& sample, devSensitivity sensitivity, int* move_x, int* move_y){
+    imu::Quaternion quat(REF_QUAT_SCALE * sample.w, REF_QUAT_SCALE * sample.x, REF_QUAT_SCALE * sample.y, REF_QUAT_SCALE * sample.z);
+    imu::Vector<3> new_euler = quat.toEuler();
+    int64_t change_x = 0;
+    int64_t change_y = 0;
+    int32_t sensitivity_level = 0;
+
+    if(_first_run){
+        _first_run = false;
+        _euler_x = new_euler.x();
+        _euler_z = new_euler.z();
+    }
+
+    for(int i=0; i<(int)SENSITIVITY_STEP_COUNT; i++){
+        if(PREF_SENSITIVITY[i] == sensitivity) sensitivity_level = i;
+    }
+
+    if(((new_euler.x() >= 3.14) && (_euler_x < -3.14)) || ((new_euler.x() < -3.14) && (_euler_x >= 3.14))){
+        change_x = (int64_t)(SCALING_FACTOR*(new_euler.x() + _euler_x));
+    }
+    else if(((new_euler.x() < -0) && (_euler_x >= 0)) || ((new_euler.x() > -0) && (_euler_x <= 0))){
+        change_x = (int64_t)(SCALING_FACTOR*(new_euler.x() + _euler_x));
+    }
+    else{
+        change_x = (int64_t)(SCALING_FACTOR*(_euler_x - new_euler.x()));
+    }
+
+    if(((new_euler.z() >= 3.14) && (_euler_z < -3.14)) || ((new_euler.z() < -3.14) && (_euler_z >= 3.14))){
+        change_y = (int64_t)(SCALING_FACTOR*(new_euler.z() + _euler_z));
+    }
+    else if(((new_euler.z() < -0) && (_euler_z >= 0)) || ((new_euler.z() > -0) && (_euler_z <= 0))){
+        change_y = (int64_t)(SCALING_FACTOR*(new_euler.z() + _euler_z));
+    }
+    else{
+        change_y = (int64_t)(SCALING_FACTOR*(new_euler.z() - _euler_z));
+    }
+
+    *move_x = _scaleAxis(change_x, sensitivity, sensitivity_level);
+    *move_y = _scaleAxis(change_y, sensitivity, sensitivity_level);
+    _change_x = (double)change_x / SCALING_FACTOR;
+    _change_y = (double)change_y / SCALING_FACTOR;
+
+    _euler_x = new_euler.x();
+    _euler_z = new_euler.z();
+}
@@ -0,0 +1,34 @@
+/* REFERENCE MOTION PIPELINE *********************************************
+ *
+ * Description: Frozen copy of the original updateMovements() motion
+ *              pipeline (Euler angles, int64 [RAD]*SCALING_FACTOR, integer
+ *              division by 20000). Used by the replay benchmark to check
+ *              that reworked pipelines produce the same cursor output.
+ *
+ ************************************************************************/
+#pragma once
+#include <stdint.h>
+#include "hm_trace.hpp"
+#include "def_preferences.hpp"
+
+/*! *********************************************************
+* @brief Original Euler/int64 motion pipeline
+*************************************************************/
+class ReferencePipeline {
+private:
+    bool _first_run = true;
+    double _euler_x = 0;
+    double _euler_z = 0;
+    double _change_x = 0;
+    double _change_y = 0;
+
+    static int _scaleAxis(int64_t change, devSensitivity sensitivity, int32_t sensitivity_level);
+
+public:
+    void reset() { _first_run = true; }
+    void update(const TraceSample& sample, devSensitivity sensitivity, int* move_x, int* move_y);
+
+    /* Head rotation of the last sample, mouse X/Y direction [RAD] */
+    double changeX() const { return _change_x; }
+    double changeY() const { return _change_y; }
+};
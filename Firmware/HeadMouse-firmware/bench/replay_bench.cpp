@@ -0,0 +1,714 @@
+/* HEADMOUSE REPLAY BENCHMARK ********************************************
+ *
+ * Description: Feeds recorded BNO055 quaternion traces through
+ *              HeadMouse::updateMovements() on the host and reports the
+ *              per-sample CPU cost (mean/p50/p99/max) and the resulting
+ *              cursor output, so that changes of the motion pipeline can
+ *              be judged for cycle cost and pointer quality. The output
+ *              is compared sample by sample to the original pipeline
+ *              (reference_pipeline.hpp).
+ *
+ *              With -b it measures the press-to-report latency of the
+ *              buttons instead (native_bench vs. native_bench_btn).
+ *              With -p it replays the traces in absolute mode as well
+ *              (native_bench_abs), with -w in scroll mode.
+ *
+ *              Build/run: pio run -e native_bench
+ *                         .pio/build/native_bench/program [options] [trace.hmt ...]
+ *
+ ************************************************************************/
+#include <Arduino.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include "host_sim.h"
+#include "hm_trace.hpp"
+#include "reference_pipeline.hpp"
+#include "default_preferences.hpp"
+#include "headmouse.hpp"
+#include "Adafruit_BNO055.h"
+
+namespace _headmouse{
+    extern Adafruit_BNO055 bno;
+    extern BleMouse bleMouse;
+}
+using namespace _headmouse;
+
+static constexpr uint32_t BENCH_DEF_REPEAT = 5;           // Timing passes per trace
+static constexpr uint32_t BENCH_SYNTH_TRACE_COUNT = 3;    // Synthetic traces if none given
+static constexpr uint32_t BENCH_SYNTH_DURATION_MS = 60000;
+static constexpr uint32_t BENCH_LOOP_STEP_US = 50;        // Simulated time per main loop spin (-a)
+static constexpr uint32_t BENCH_SENSOR_CLOCK_PERMILLE = 1005;   // BNO055 clock 0.5% slower than the MCU clock (-a)
+static constexpr uint32_t BENCH_BTN_PUSHES = 50;         // Pushes per button scenario (-b)
+static constexpr uint32_t BENCH_BTN_BOUNCES = 4;         // Contact bounces after each edge (-b)
+static constexpr uint32_t BENCH_BTN_BOUNCE_US = 300;     // Time between contact bounces (-b)
+static constexpr uint32_t BENCH_BTN_PAUSE_MS = 300;      // Time between two pushes (-b)
+static constexpr uint32_t BENCH_RETURN_MS = 1000;         // Head movement back to the first pose (-p)
+static constexpr uint32_t BENCH_RETURN_REST_MS = 500;     // Rest in the first pose after the return (-p)
+#ifdef HM_HID_16BIT
+static constexpr size_t REPORT_WHEEL_INDEX = 5;           // Wheel byte of the mouse report (-w)
+#else
+static constexpr size_t REPORT_WHEEL_INDEX = 3;
+#endif
+
+/*! *********************************************************
+* @brief Cursor output of a single replayed sample
+*************************************************************/
+struct SampleOutput {
+    int32_t dx = 0;
+    int32_t dy = 0;
+};
+
+/*! *********************************************************
+* @brief Benchmark result of one trace
+*************************************************************/
+struct TraceResult {
+    std::vector<uint32_t> cost_ns;
+    std::vector<SampleOutput> output;
+    std::vector<SampleOutput> reference;
+    double exact_dx = 0;            // Cursor travel without truncation [counts]
+    double exact_dy = 0;
+    double rotation_deg = 0;        // Total head rotation [deg]
+    uint32_t report_count = 0;
+};
+
+static SampleOutput _current_output;
+static uint64_t _report_down_us = 0;        // Time of the first HID report with LEFT pressed, 0 if none (-b)
+static uint64_t _report_up_us = 0;          // Time of the first HID report releasing LEFT again, 0 if none (-b)
+
+/************************************************************
+ * @brief Collect the HID reports of the currently replayed sample.
+ *************************************************************/
+static void _onReport(const uint8_t* report, size_t len){
+#ifdef HM_HID_16BIT
+    if(len < 5) return;
+    _current_output.dx += (int16_t)(report[1] | (report[2] << 8));
+    _current_output.dy += (int16_t)(report[3] | (report[4] << 8));
+#else
+    if(len < 3) return;
+    _current_output.dx += (int8_t)report[1];
+    _current_output.dy += (int8_t)report[2];
+#endif
+}
+
+/************************************************************
+ * @brief Track the LEFT button state of the HID reports (-b).
+ *************************************************************/
+static void _onButtonReport(const uint8_t* report, size_t len){
+    if(len < 1) return;
+    if((_report_down_us == 0) && (report[0] & MOUSE_LEFT)) _report_down_us = host::nowMicros();
+    else if((_report_down_us != 0) && (_report_up_us == 0) && !(report[0] & MOUSE_LEFT)) _report_up_us = host::nowMicros();
+}
+
+#ifdef HM_HID_ABSOLUTE
+static int32_t _abs_x = 0;                  // Pointer position of the last absolute report (-p)
+static int32_t _abs_y = 0;
+static int32_t _abs_jump_max = 0;           // Largest position change of one absolute report (-p)
+
+/************************************************************
+ * @brief Track the pointer position of the absolute reports (-p).
+ *************************************************************/
+static void _onAbsReport(const uint8_t* report, size_t len){
+    if(len < 5) return;
+    int32_t x = report[1] | (report[2] << 8);
+    int32_t y = report[3] | (report[4] << 8);
+    _abs_jump_max = std::max(_abs_jump_max, std::max(abs(x - _abs_x), abs(y - _abs_y)));
+    _abs_x = x;
+    _abs_y = y;
+}
+#endif
+
+/*! *********************************************************
+* @brief Wheel output of a scroll replay (-w)
+*************************************************************/
+struct ScrollOutput {
+    uint32_t reports = 0;       // Reports moving a wheel
+    int32_t wheel = 0;          // [counts]
+    int32_t pan = 0;
+    uint32_t wheel_travel = 0;
+    uint32_t pan_travel = 0;
+    int32_t step_max = 0;       // Largest wheel movement of one report [counts]
+};
+static ScrollOutput _scroll_output;
+
+/************************************************************
+ * @brief Collect the wheel movements of the HID reports (-w).
+ *************************************************************/
+static void _onScrollReport(const uint8_t* report, size_t len){
+    if(len < REPORT_WHEEL_INDEX + 2) return;
+    int32_t wheel = (int8_t)report[REPORT_WHEEL_INDEX];
+    int32_t pan = (int8_t)report[REPORT_WHEEL_INDEX + 1];
+    if((wheel == 0) && (pan == 0)) return;
+
+    _scroll_output.reports++;
+    _scroll_output.wheel += wheel;
+    _scroll_output.pan += pan;
+    _scroll_output.wheel_travel += abs(wheel);
+    _scroll_output.pan_travel += abs(pan);
+    _scroll_output.step_max = std::max(_scroll_output.step_max, std::max(abs(wheel), abs(pan)));
+}
+
+static void _feedSample(const TraceSample& sample){
+    bno.setRawQuat({sample.w, sample.x, sample.y, sample.z});
+}
+
+/************************************************************
+ * @brief Mouse counts of a head rotation along the default 
+ *        pointer acceleration curve, without truncation.
+ *
+ * @param change Head rotation [RAD].
+ * @param dt_us Sample interval [us].
+ * @param sensitivity Active sensitivity.
+ * @return Mouse counts.
+ *************************************************************/
+static double _idealCounts(double change, uint32_t dt_us, devSensitivity sensitivity){
+    int32_t velocity = (int32_t)std::min(fabs(change) * 1e6 / dt_us * (1 << MOTION_V_SHIFT), (double)MOTION_V_MAX);
+    int level = 0;
+
+    for(int i=0; i<(int)SENSITIVITY_STEP_COUNT; i++){
+        if(PREF_SENSITIVITY[i] == sensitivity) level = i;
+    }
+    if(velocity <= JITTER_VELOCITY_Q) return 0.0;
+    return change * MotionCurveTable::curveGain(MOTION_CURVE_DEFAULT[level], velocity);
+}
+
+/************************************************************
+ * @brief Replay a trace through the motion pipeline.
+ *
+ * The first sample is fed untimed to align the pipeline state
+ * with the trace start. Outputs are taken from the first pass,
+ * CPU cost is collected over all passes.
+ *
+ * @param hm HeadMouse instance under test.
+ * @param trace Motion trace to replay.
+ * @param sensitivity Active sensitivity of hm.
+ * @param repeat Number of timing passes.
+ * @param result Output benchmark result.
+ *************************************************************/
+static void _replay(HeadMouse& hm, const Trace& trace, devSensitivity sensitivity, uint32_t repeat, TraceResult* result){
+    ReferencePipeline reference;
+    int ref_x = 0, ref_y = 0;
+    result->cost_ns.reserve(trace.samples.size() * repeat);
+    result->output.resize(trace.samples.size());
+    result->reference.resize(trace.samples.size());
+    uint32_t reports_start = bleMouse.getReportCount();
+
+    /* Reference output at full magnitude, large movements are split into several HID reports */
+    reference.update(trace.samples[0], sensitivity, &ref_x, &ref_y);
+    for(size_t i=0; i<trace.samples.size(); i++){
+        reference.update(trace.samples[i], sensitivity, &ref_x, &ref_y);
+        result->reference[i].dx = ref_x;
+        result->reference[i].dy = ref_y;
+        uint32_t dt_us = (i > 0) ? trace.samples[i].t_us - trace.samples[i-1].t_us : PROGRAM_CYCLE_INTERVAL_MS*1000;
+        dt_us = std::min(std::max(dt_us, MOTION_DT_MIN_US), MOTION_DT_MAX_US);
+        result->exact_dx += _idealCounts(reference.changeX(), dt_us, sensitivity);
+        result->exact_dy += _idealCounts(reference.changeY(), dt_us, sensitivity);
+        result->rotation_deg += (fabs(reference.changeX()) + fabs(reference.changeY())) * 180.0 / M_PI;
+    }
+
+    for(uint32_t pass=0; pass<repeat; pass++){
+        /* HID reports are paced, keep a program cycle between the calls like loop(). Repeat until
+           the jump to the first sample has been sent completely, it may need several reports. */
+        uint32_t reports = 0;
+        do{
+            reports = bleMouse.getReportCount();
+            host::advanceMicros(PROGRAM_CYCLE_INTERVAL_MS*1000);
+            _feedSample(trace.samples[0]);
+            hm.updateMovements();
+        } while(bleMouse.getReportCount() != reports);
+        host::advanceMicros(PROGRAM_CYCLE_INTERVAL_MS*1000);
+        uint64_t t_start = host::nowMicros();
+
+        for(size_t i=0; i<trace.samples.size(); i++){
+            const TraceSample& sample = trace.samples[i];
+            uint64_t t_sample = t_start + sample.t_us;
+            if(t_sample > host::nowMicros()) host::advanceMicros(t_sample - host::nowMicros());
+
+            _feedSample(sample);
+            _current_output = SampleOutput();
+
+            auto t0 = std::chrono::steady_clock::now();
+            hm.updateMovements();
+            auto t1 = std::chrono::steady_clock::now();
+
+            result->cost_ns.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            if(pass == 0) result->output[i] = _current_output;
+        }
+        if(pass == 0) result->report_count = bleMouse.getReportCount() - reports_start;
+    }
+}
+
+/************************************************************
+ * @brief Replay a trace through the main loop scheduling.
+ *
+ * Samples are injected at their (sensor clock) timestamps, the
+ * program cycles are started as in loop() by the tick counter.
+ * Reports the age of the samples when read.
+ *
+ * @param hm HeadMouse instance under test.
+ * @param trace Motion trace to replay.
+ *************************************************************/
+static void _replayLoop(HeadMouse& hm, const Trace& trace, const char* name){
+    uint64_t t_start = host::nowMicros();
+    uint64_t t_end = t_start + (uint64_t)trace.samples.back().t_us * BENCH_SENSOR_CLOCK_PERMILLE / 1000 + 10000;
+    size_t next = 0;
+
+    hm.resetCycleStats();
+    while(host::nowMicros() < t_end){
+        if(hm.isMeasurementAvailable()) hm.updateMovements();
+
+        /* Samples arrive at their own time, the main loop sees them with the next spin */
+        uint64_t t_spin = host::nowMicros() + BENCH_LOOP_STEP_US;
+        while(next < trace.samples.size()){
+            uint64_t t_sample = t_start + (uint64_t)trace.samples[next].t_us * BENCH_SENSOR_CLOCK_PERMILLE / 1000;
+            if(t_sample >= t_spin) break;
+            if(t_sample > host::nowMicros()) host::advanceMicros(t_sample - host::nowMicros());
+            _feedSample(trace.samples[next++]);
+        }
+        host::advanceMicros(t_spin - host::nowMicros());
+    }
+
+    HmCycleStats stats = hm.getCycleStats();
+    const HmSampleStats& sample = stats.sample;
+    printf("%-24s %8zu %8u %8u %8u %8u %8u %9.0f %8u ", name, trace.samples.size(), stats.cycles, sample.samples, 
+           sample.duplicates, sample.skipped, stats.missed_ticks, sample.samples ? (double)sample.age_sum_us / sample.samples : 0.0, 
+           sample.age_max_us);
+    for(uint32_t i=0; i<SAMPLE_AGE_BUCKET_COUNT; i++) printf(" %5.1f", sample.samples ? 100.0 * sample.age_histogram[i] / sample.samples : 0.0);
+    printf("\n");
+}
+
+#ifdef HM_HID_ABSOLUTE
+/************************************************************
+ * @brief Append a return of the head to the first pose (-p).
+ *
+ * Slerp along a minimum-jerk profile, followed by a rest, so the
+ * last sample has exactly the head pose of the first one.
+ *
+ * @param trace Motion trace to extend.
+ *************************************************************/
+static void _appendReturn(Trace* trace){
+    const TraceSample first = trace->samples.front();
+    const TraceSample last = trace->samples.back();
+    double q0[4] = {(double)last.w, (double)last.x, (double)last.y, (double)last.z};
+    double q1[4] = {(double)first.w, (double)first.x, (double)first.y, (double)first.z};
+    double dot = 0, norm0 = 0, norm1 = 0;
+
+    for(int k=0; k<4; k++){ norm0 += q0[k]*q0[k]; norm1 += q1[k]*q1[k]; }
+    for(int k=0; k<4; k++){ q0[k] /= sqrt(norm0); q1[k] /= sqrt(norm1); dot += q0[k]*q1[k]; }
+    if(dot < 0){
+        dot = -dot;
+        for(int k=0; k<4; k++) q1[k] = -q1[k];
+    }
+    double theta = acos(std::min(dot, 1.0));
+
+    uint32_t steps = (BENCH_RETURN_MS + BENCH_RETURN_REST_MS) * 1000 / trace->sample_interval_us;
+    uint32_t move_steps = BENCH_RETURN_MS * 1000 / trace->sample_interval_us;
+    for(uint32_t i=1; i<=steps; i++){
+        double s = std::min(1.0, (double)i / move_steps);
+        double jerk = s * s * s * (10 - 15 * s + 6 * s * s);
+        double a = (theta > 1e-9) ? sin((1 - jerk) * theta) / sin(theta) : 1 - jerk;
+        double b = (theta > 1e-9) ? sin(jerk * theta) / sin(theta) : jerk;
+        TraceSample sample = (jerk >= 1.0) ? first : last;
+        if(jerk < 1.0){
+            sample.w = (int16_t)lround((a*q0[0] + b*q1[0]) * (1 << 14));
+            sample.x = (int16_t)lround((a*q0[1] + b*q1[1]) * (1 << 14));
+            sample.y = (int16_t)lround((a*q0[2] + b*q1[2]) * (1 << 14));
+            sample.z = (int16_t)lround((a*q0[3] + b*q1[3]) * (1 << 14));
+        }
+        sample.t_us = last.t_us + i * trace->sample_interval_us;
+        trace->samples.push_back(sample);
+    }
+}
+
+/************************************************************
+ * @brief Replay a trace in relative and absolute mode (-p).
+ *
+ * The trace is extended by a return to the first head pose, the
+ * absolute pointer is recentred on the first sample. The return
+ * error is the pointer offset between first and last sample: 
+ * position [counts of ABS_POSITION_MAX] in absolute mode, 
+ * accumulated cursor travel [counts] in relative mode.
+ *
+ * @param hm HeadMouse instance under test.
+ * @param trace Motion trace to replay.
+ * @param sensitivity Active sensitivity of hm.
+ * @param name Trace name.
+ *************************************************************/
+static void _replayAbsolute(HeadMouse& hm, Trace trace, devSensitivity sensitivity, const char* name){
+    TraceResult relative;
+    int32_t x_min = ABS_POSITION_MAX, x_max = 0, y_min = ABS_POSITION_MAX, y_max = 0;
+    int32_t x_first = 0, y_first = 0;
+    int64_t rel_dx = 0, rel_dy = 0;
+
+    _appendReturn(&trace);
+    hm.setMode(RELATIVE);
+    _replay(hm, trace, sensitivity, 1, &relative);
+    for(size_t i=1; i<relative.output.size(); i++){
+        rel_dx += relative.output[i].dx;
+        rel_dy += relative.output[i].dy;
+    }
+
+    hm.setMode(ABSOLUTE);
+    uint32_t reports = 0;
+    do{
+        reports = bleMouse.getReportCount();
+        host::advanceMicros(PROGRAM_CYCLE_INTERVAL_MS*1000);
+        _feedSample(trace.samples[0]);
+        hm.updateMovements();
+    } while(bleMouse.getReportCount() != reports);
+    host::advanceMicros(PROGRAM_CYCLE_INTERVAL_MS*1000);
+    uint64_t t_start = host::nowMicros();
+    uint32_t reports_start = bleMouse.getReportCount();
+    _abs_jump_max = 0;
+
+    for(size_t i=0; i<trace.samples.size(); i++){
+        const TraceSample& sample = trace.samples[i];
+        uint64_t t_sample = t_start + sample.t_us;
+        if(t_sample > host::nowMicros()) host::advanceMicros(t_sample - host::nowMicros());
+        _feedSample(sample);
+        hm.updateMovements();
+
+        if(i == 0){
+            x_first = _abs_x;
+            y_first = _abs_y;
+        }
+        x_min = std::min(x_min, _abs_x); x_max = std::max(x_max, _abs_x);
+        y_min = std::min(y_min, _abs_y); y_max = std::max(y_max, _abs_y);
+    }
+    hm.setMode(RELATIVE);
+
+    int32_t abs_err = std::max(abs(_abs_x - x_first), abs(_abs_y - y_first));
+    printf("%-24s %8zu %8u %6d..%-6d %6d..%-6d %8d %8d %8lld\n", name, trace.samples.size(), 
+           bleMouse.getReportCount() - reports_start, x_min, x_max, y_min, y_max, _abs_jump_max, abs_err, 
+           (long long)std::max(llabs(rel_dx), llabs(rel_dy)));
+}
+#endif
+
+/************************************************************
+ * @brief Replay a trace in scroll mode (-w).
+ *
+ * Reports the wheel output in detents and the largest step of a
+ * single report, for a host with and (HM_HID_HIRES_WHEEL only)
+ * without the high-resolution wheel.
+ *
+ * @param hm HeadMouse instance under test.
+ * @param trace Motion trace to replay.
+ * @param name Trace name.
+ * @param multiplier Resolution multiplier set by the simulated host.
+ *************************************************************/
+static void _replayScroll(HeadMouse& hm, const Trace& trace, const char* name, uint8_t multiplier){
+    bleMouse.setHostWheelMultiplier(multiplier);
+    hm.setScrolling(true);
+    host::advanceMicros(PROGRAM_CYCLE_INTERVAL_MS*1000);
+    _feedSample(trace.samples[0]);
+    hm.updateMovements();
+    host::advanceMicros(PROGRAM_CYCLE_INTERVAL_MS*1000);
+    uint64_t t_start = host::nowMicros();
+    _scroll_output = ScrollOutput();
+
+    for(const TraceSample& sample : trace.samples){
+        uint64_t t_sample = t_start + sample.t_us;
+        if(t_sample > host::nowMicros()) host::advanceMicros(t_sample - host::nowMicros());
+        _feedSample(sample);
+        hm.updateMovements();
+    }
+    hm.setScrolling(false);
+
+    uint8_t m = bleMouse.getWheelMultiplier();
+    printf("%-24s %10u %8u %10.2f %10.2f %10.2f %10.2f %8.3f\n", name, m, _scroll_output.reports, 
+           (double)_scroll_output.wheel / m, (double)_scroll_output.wheel_travel / m, (double)_scroll_output.pan / m, 
+           (double)_scroll_output.pan_travel / m, (double)_scroll_output.step_max / m);
+}
+
+static uint32_t _percentile(std::vector<uint32_t> sorted, double p){
+    if(sorted.empty()) return 0;
+    size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+/************************************************************
+ * @brief Run the main loop scheduling until a time.
+ *
+ * @param hm HeadMouse instance under test.
+ * @param t_end Simulated time to stop [us].
+ *************************************************************/
+static void _runLoopUntil(HeadMouse& hm, uint64_t t_end){
+    while(host::nowMicros() < t_end){
+        if(hm.isMeasurementAvailable()){
+            hm.updateBtnActions();
+            hm.updateMovements();
+        }
+        host::advanceMicros(std::min<uint64_t>(BENCH_LOOP_STEP_US, t_end - host::nowMicros()));
+    }
+}
+
+/************************************************************
+ * @brief Set the level of a bouncing button contact.
+ *
+ * @param hm HeadMouse instance under test.
+ * @param level Final pin level.
+ *************************************************************/
+static void _bounceButton(HeadMouse& hm, int level){
+    host::setPinLevel(PIN_BTN_1, level);
+    for(uint32_t i=0; i<BENCH_BTN_BOUNCES; i++){
+        _runLoopUntil(hm, host::nowMicros() + BENCH_BTN_BOUNCE_US);
+        host::setPinLevel(PIN_BTN_1, (i % 2) ? level : !level);
+    }
+}
+
+/************************************************************
+ * @brief Push button 1 (LEFT) with contact bounce and report the
+ *        latency from the first edge of the push/release to the 
+ *        HID report with the new button state.
+ *
+ * The pushes start at varying phases of the program cycle. A push
+ * which is not reported at all counts as lost.
+ *
+ * @param hm HeadMouse instance under test.
+ * @param hold_ms Time between first edge of push and release.
+ *************************************************************/
+static void _benchButton(HeadMouse& hm, uint32_t hold_ms){
+    std::vector<uint32_t> down_us, up_us;
+    uint32_t lost = 0;
+
+    for(uint32_t i=0; i<BENCH_BTN_PUSHES; i++){
+        _runLoopUntil(hm, host::nowMicros() + BENCH_BTN_PAUSE_MS*1000 + (i * 1237) % (PROGRAM_CYCLE_INTERVAL_MS*1000));
+        uint64_t t_push = host::nowMicros();
+
+        _report_down_us = 0;
+        _report_up_us = 0;
+        _bounceButton(hm, LOW);
+        _runLoopUntil(hm, t_push + hold_ms*1000);
+
+        uint64_t t_release = host::nowMicros();
+        _bounceButton(hm, HIGH);
+        _runLoopUntil(hm, t_release + BENCH_BTN_PAUSE_MS*1000);
+
+        if(_report_down_us == 0){
+            lost++;
+            continue;
+        }
+        down_us.push_back((uint32_t)(_report_down_us - t_push));
+        if(_report_up_us >= t_release) up_us.push_back((uint32_t)(_report_up_us - t_release));
+    }
+
+    std::sort(down_us.begin(), down_us.end());
+    std::sort(up_us.begin(), up_us.end());
+    uint64_t down_sum = 0, up_sum = 0;
+    for(uint32_t us : down_us) down_sum += us;
+    for(uint32_t us : up_us) up_sum += us;
+
+    printf("%8u %8u %8u %10.0f %10u %10u %10.0f %10u %10u\n", hold_ms, BENCH_BTN_PUSHES, lost,
+           down_us.empty() ? 0.0 : (double)down_sum / down_us.size(), _percentile(down_us, 0.5), down_us.empty() ? 0 : down_us.back(),
+           up_us.empty() ? 0.0 : (double)up_sum / up_us.size(), _percentile(up_us, 0.5), up_us.empty() ? 0 : up_us.back());
+}
+
+/************************************************************
+ * @brief Print the benchmark result of a trace.
+ *
+ * The checksum (FNV-1a over all per-sample outputs) changes
+ * whenever the cursor output of the pipeline changes. ref_max
+ * is the largest per-sample deviation from the reference
+ * pipeline, ref>1 the number of samples deviating by more than
+ * one count. err/deg is the pointing error: deviation of the
+ * total cursor travel from the untruncated head rotation
+ * [counts] per degree of head rotation.
+ *************************************************************/
+static void _printResult(const char* name, const TraceResult& result){
+    std::vector<uint32_t> sorted = result.cost_ns;
+    std::sort(sorted.begin(), sorted.end());
+
+    uint64_t sum_ns = 0;
+    for(uint32_t ns : sorted) sum_ns += ns;
+
+    int64_t sum_dx = 0, sum_dy = 0, travel = 0;
+    uint32_t checksum = 2166136261u;
+    int32_t ref_max = 0;
+    uint32_t ref_over = 0;
+    for(size_t i=0; i<result.output.size(); i++){
+        const SampleOutput& out = result.output[i];
+        int32_t diff = std::max(abs(out.dx - result.reference[i].dx), abs(out.dy - result.reference[i].dy));
+        ref_max = std::max(ref_max, diff);
+        if(diff > 1) ref_over++;
+
+        sum_dx += out.dx;
+        sum_dy += out.dy;
+        travel += abs(out.dx) + abs(out.dy);
+        checksum = (checksum ^ (uint32_t)out.dx) * 16777619u;
+        checksum = (checksum ^ (uint32_t)out.dy) * 16777619u;
+    }
+
+    double pointing_error = fabs(sum_dx - result.exact_dx) + fabs(sum_dy - result.exact_dy);
+    double error_per_deg = (result.rotation_deg > 0) ? pointing_error / result.rotation_deg : 0.0;
+
+    printf("%-24s %8zu %9.1f %8u %8u %8u %8u %8lld %8lld %9lld  %08x %8d %8u %8.4f\n", name, result.output.size(),
+           sorted.empty() ? 0.0 : (double)sum_ns / sorted.size(),
+           _percentile(sorted, 0.5), _percentile(sorted, 0.99), sorted.empty() ? 0 : sorted.back(),
+           result.report_count, (long long)sum_dx, (long long)sum_dy, (long long)travel, checksum, ref_max, ref_over,
+           error_per_deg);
+}
+
+static bool _dumpOutput(const char* path, const Trace& trace, const TraceResult& result){
+    FILE* file = fopen(path, "w");
+    if(file == nullptr) return false;
+
+    fprintf(file, "t_us,dx,dy,ref_dx,ref_dy\n");
+    for(size_t i=0; i<result.output.size(); i++){
+        fprintf(file, "%u,%d,%d,%d,%d\n", trace.samples[i].t_us, result.output[i].dx, result.output[i].dy,
+                result.reference[i].dx, result.reference[i].dy);
+    }
+    fclose(file);
+    return true;
+}
+
+static void _usage(){
+    printf("Usage: replay_bench [options] [trace.hmt ...]\n"
+           "  -r N              timing passes per trace (default %u)\n"
+           "  -s N              sensitivity level 0..%u (default: firmware default)\n"
+           "  -d FILE           dump per-sample output of the first trace as csv\n"
+           "  -a                replay through the main loop scheduling and report the sample age\n"
+           "  -b                measure the press-to-report latency of button 1 (LEFT)\n"
+           "  -w                replay in scroll mode and report the wheel output\n"
+#ifdef HM_HID_ABSOLUTE
+           "  -p                replay in absolute mode, report pointer range and return error\n"
+#endif
+           "  -g FILE SEED      write a synthetic trace and exit\n"
+           "  -c CAPTURE FILE   convert a [TRACE_IMU] serial capture into a trace and exit\n"
+           "Without trace files %u synthetic traces are replayed.\n",
+           BENCH_DEF_REPEAT, SENSITIVITY_STEP_COUNT - 1, BENCH_SYNTH_TRACE_COUNT);
+}
+
+int main(int argc, char** argv){
+    uint32_t repeat = BENCH_DEF_REPEAT;
+    devSensitivity sensitivity = HM_DEF_SENSITIVITY;
+    const char* dump_path = nullptr;
+    bool sample_age = false;
+    bool button_latency = false;
+    bool absolute = false;
+    bool scroll = false;
+    std::vector<const char*> trace_paths;
+
+    for(int i=1; i<argc; i++){
+        if(!strcmp(argv[i], "-r") && (i + 1 < argc)) repeat = std::max(1, atoi(argv[++i]));
+        else if(!strcmp(argv[i], "-s") && (i + 1 < argc)){
+            int level = atoi(argv[++i]);
+            if((level < 0) || (level >= (int)SENSITIVITY_STEP_COUNT)){ _usage(); return 1; }
+            sensitivity = PREF_SENSITIVITY[level];
+        }
+        else if(!strcmp(argv[i], "-d") && (i + 1 < argc)) dump_path = argv[++i];
+        else if(!strcmp(argv[i], "-a")) sample_age = true;
+        else if(!strcmp(argv[i], "-b")) button_latency = true;
+        else if(!strcmp(argv[i], "-w")) scroll = true;
+#ifdef HM_HID_ABSOLUTE
+        else if(!strcmp(argv[i], "-p")) absolute = true;
+#endif
+        else if(!strcmp(argv[i], "-g") && (i + 2 < argc)){
+            Trace trace;
+            traceSynthesize((uint32_t)atoi(argv[i + 2]), BENCH_SYNTH_DURATION_MS, &trace);
+            return traceWrite(argv[i + 1], trace) ? 0 : 1;
+        }
+        else if(!strcmp(argv[i], "-c") && (i + 2 < argc)){
+            Trace trace;
+            if(!traceConvertCapture(argv[i + 1], &trace)) return 1;
+            printf("%zu samples converted\n", trace.samples.size());
+            return traceWrite(argv[i + 2], trace) ? 0 : 1;
+        }
+        else if(argv[i][0] == '-'){ _usage(); return 1; }
+        else trace_paths.push_back(argv[i]);
+    }
+
+    HmPreferences preferences;
+    preferences.mode = HM_DEF_MODE;
+    preferences.sensititvity = sensitivity;
+    preferences.btn_actions[0] = HM_DEF_ACTION_BTN_1;
+    preferences.btn_actions[1] = HM_DEF_ACTION_BTN_2;
+    preferences.btn_actions[2] = HM_DEF_ACTION_BTN_3;
+    preferences.btn_actions[3] = HM_DEF_ACTION_BTN_4;
+
+    HeadMouse hm;
+    bno.hostConnectIntPin(PIN_BNO55_INT);
+    if(hm.init(preferences) != ERR_NONE){
+        printf("HeadMouse init failed\n");
+        return 1;
+    }
+    hm.updateDevStatus();
+    bleMouse.setReportCallback(_onReport);
+
+    if(button_latency){
+        static const uint32_t hold_ms[] = {40, 120, 400};
+        bleMouse.setReportCallback(_onButtonReport);
+        printf("%8s %8s %8s %10s %10s %10s %10s %10s %10s\n", "hold[ms]", "pushes", "lost", "down[us]", "p50[us]", "max[us]",
+               "up[us]", "p50[us]", "max[us]");
+        for(uint32_t hold : hold_ms) _benchButton(hm, hold);
+        return 0;
+    }
+
+    if(scroll){
+        bleMouse.setReportCallback(_onScrollReport);
+        printf("%-24s %10s %8s %10s %10s %10s %10s %8s\n", "trace", "multiplier", "reports", "wheel", "travel", "pan", 
+               "travel", "step_max");
+    }
+    else if(absolute){
+#ifdef HM_HID_ABSOLUTE
+        bleMouse.setAbsReportCallback(_onAbsReport);
+#endif
+        printf("%-24s %8s %8s %14s %14s %8s %8s %8s\n", "trace", "samples", "reports", "x", "y", "jump_max", 
+               "abs_err", "rel_err");
+    }
+    else if(sample_age){
+        printf("%-24s %8s %8s %8s %8s %8s %8s %9s %8s  age histogram [%% per %u us]\n", "trace", "samples", "cycles", "read", 
+               "dup", "skipped", "missed", "age[us]", "max[us]", SAMPLE_AGE_BUCKET_US);
+    }
+    else{
+        printf("%-24s %8s %9s %8s %8s %8s %8s %8s %8s %9s  %8s %8s %8s %8s\n", "trace", "samples", "mean[ns]", "p50[ns]",
+               "p99[ns]", "max[ns]", "reports", "sum_dx", "sum_dy", "travel", "checksum", "ref_max", "ref>1", "err/deg");
+    }
+
+    size_t trace_count = trace_paths.empty() ? BENCH_SYNTH_TRACE_COUNT : trace_paths.size();
+    for(size_t i=0; i<trace_count; i++){
+        Trace trace;
+        char name[32];
+        const char* label = name;
+
+        if(trace_paths.empty()){
+            snprintf(name, sizeof(name), "synthetic-%zu", i + 1);
+            traceSynthesize((uint32_t)(i + 1), BENCH_SYNTH_DURATION_MS, &trace);
+        }
+        else{
+            label = trace_paths[i];
+            if(!traceRead(trace_paths[i], &trace) || trace.samples.empty()){
+                printf("%-24s invalid trace\n", label);
+                continue;
+            }
+        }
+
+        if(sample_age){
+            _replayLoop(hm, trace, label);
+            continue;
+        }
+        if(scroll){
+            _replayScroll(hm, trace, label, 1);
+#ifdef HM_HID_HIRES_WHEEL
+            _replayScroll(hm, trace, label, WHEEL_HIRES_MULTIPLIER);
+#endif
+            continue;
+        }
+#ifdef HM_HID_ABSOLUTE
+        if(absolute){
+            _replayAbsolute(hm, trace, sensitivity, label);
+            continue;
+        }
+#endif
+
+        TraceResult result;
+        _replay(hm, trace, sensitivity, repeat, &result);
+        _printResult(label, result);
+
+        if((i == 0) && (dump_path != nullptr) && !_dumpOutput(dump_path, trace, result)){
+            printf("Cannot write %s\n", dump_path);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "hm_trace.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <random>
+
+static constexpr double TRACE_QUAT_SCALE = (1 << 14);  // BNO055 quaternion LSB per unit
+static constexpr char TRACE_CAPTURE_TAG[] = "[TRACE_IMU] ";
+
+/************************************************************
+ * @brief Read a binary motion trace from file.
+ *
+ * @param path Path of the trace file.
+ * @param trace Output trace.
+ * @return TRUE if the file is a valid trace, FALSE otherwise.
+ *************************************************************/
+bool traceRead(const char* path, Trace* trace){
+    TraceHeader header;
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr) return false;
+
+    bool ok = (fread(&header, sizeof(header), 1, file) == 1) &&
+              (memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0) &&
+              (header.version == TRACE_VERSION);
+    if(ok){
+        trace->sample_interval_us = header.sample_interval_us;
+        trace->samples.resize(header.sample_count);
+        ok = (header.sample_count == 0) ||
+             (fread(trace->samples.data(), sizeof(TraceSample), header.sample_count, file) == header.sample_count);
+    }
+
+    fclose(file);
+    return ok;
+}
+
+/************************************************************
+ * @brief Write a binary motion trace to file.
+ *
+ * @param path Path of the trace file.
+ * @param trace Trace to store.
+ * @return TRUE if the file has been written, FALSE otherwise.
+ *************************************************************/
+bool traceWrite(const char* path, const Trace& trace){
+    TraceHeader header;
+    memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.version = TRACE_VERSION;
+    header.reserved = 0;
+    header.sample_interval_us = trace.sample_interval_us;
+    header.sample_count = (uint32_t)trace.samples.size();
+
+    FILE* file = fopen(path, "wb");
+    if(file == nullptr) return false;
+
+    bool ok = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+              (fwrite(trace.samples.data(), sizeof(TraceSample), trace.samples.size(), file) == trace.samples.size());
+
+    fclose(file);
+    return ok;
+}
+
+/************************************************************
+ * @brief Convert a serial log capture into a motion trace.
+ *
+ * Parses all "[TRACE_IMU] t_us,w,x,y,z" lines written by the
+ * firmware if LOG_LEVEL_TRACE_IMU is enabled. Timestamps are
+ * made relative to the first sample.
+ *
+ * @param capture_path Path of the captured serial log.
+ * @param trace Output trace.
+ * @return TRUE if at least one sample has been found.
+ *************************************************************/
+bool traceConvertCapture(const char* capture_path, Trace* trace){
+    char line[128];
+    bool first = true;
+    unsigned long t0 = 0;
+    FILE* file = fopen(capture_path, "r");
+    if(file == nullptr) return false;
+
+    trace->samples.clear();
+    while(fgets(line, sizeof(line), file) != nullptr){
+        const char* data = strstr(line, TRACE_CAPTURE_TAG);
+        unsigned long t = 0;
+        int w, x, y, z;
+        if(data == nullptr) continue;
+        if(sscanf(data + strlen(TRACE_CAPTURE_TAG), "%lu,%d,%d,%d,%d", &t, &w, &x, &y, &z) != 5) continue;
+
+        if(first){
+            first = false;
+            t0 = t;
+        }
+        trace->samples.push_back({(uint32_t)(t - t0), (int16_t)w, (int16_t)x, (int16_t)y, (int16_t)z});
+    }
+    fclose(file);
+
+    if(trace->samples.size() > 1){
+        trace->sample_interval_us = trace->samples.back().t_us / (uint32_t)(trace->samples.size() - 1);
+    }
+    return !trace->samples.empty();
+}
+
+/************************************************************
+ * @brief Convert yaw/pitch/roll to a raw BNO055 quaternion.
+ *
+ * Angles are chosen so that imu::Quaternion::toEuler() returns
+ * x = yaw (mouse X axis) and z = pitch (mouse Y axis).
+ *************************************************************/
+static TraceSample _toSample(uint32_t t_us, double yaw, double roll, double pitch){
+    double cy = cos(yaw / 2), sy = sin(yaw / 2);
+    double cr = cos(roll / 2), sr = sin(roll / 2);
+    double cp = cos(pitch / 2), sp = sin(pitch / 2);
+
+    double w = cp * cr * cy + sp * sr * sy;
+    double x = sp * cr * cy - cp * sr * sy;
+    double y = cp * sr * cy + sp * cr * sy;
+    double z = cp * cr * sy - sp * sr * cy;
+
+    return {t_us, (int16_t)lround(w * TRACE_QUAT_SCALE), (int16_t)lround(x * TRACE_QUAT_SCALE),
+            (int16_t)lround(y * TRACE_QUAT_SCALE), (int16_t)lround(z * TRACE_QUAT_SCALE)};
+}
+
+/************************************************************
+ * @brief Generate a synthetic head motion trace.
+ *
+ * The trace is a deterministic mix of resting (sensor noise
+ * only), slow precise drifts and fast minimum-jerk head turns
+ * sampled at 100 Hz with occasional late samples. Used as a
+ * reproducible corpus if no recorded traces are available.
+ *
+ * @param seed Random seed, equal seeds produce equal traces.
+ * @param duration_ms Length of the trace.
+ * @param trace Output trace.
+ *************************************************************/
+void traceSynthesize(uint32_t seed, uint32_t duration_ms, Trace* trace){
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> noise(0.0, 0.00005);
+
+    double yaw = -2.5 + 5.0 * uniform(rng);
+    double pitch = -0.5 + 1.0 * uniform(rng);
+    double roll = -0.1 + 0.2 * uniform(rng);
+    uint32_t t_us = 0;
+
+    trace->sample_interval_us = 10000;
+    trace->samples.clear();
+
+    while(t_us < duration_ms * 1000){
+        double kind = uniform(rng);
+        uint32_t segment_us = 0;
+        double start_yaw = yaw, start_pitch = pitch;
+        double d_yaw = 0, d_pitch = 0;
+
+        if(kind < 0.3){         /* Rest */
+            segment_us = (uint32_t)(300000 + 700000 * uniform(rng));
+        }
+        else if(kind < 0.65){   /* Slow, precise drift */
+            segment_us = (uint32_t)(500000 + 1000000 * uniform(rng));
+            d_yaw = (uniform(rng) - 0.5) * 0.1;
+            d_pitch = (uniform(rng) - 0.5) * 0.06;
+        }
+        else{                   /* Fast head turn */
+            segment_us = (uint32_t)(150000 + 350000 * uniform(rng));
+            d_yaw = (uniform(rng) - 0.5) * 1.0;
+            d_pitch = (uniform(rng) - 0.5) * 0.5;
+        }
+
+        uint32_t start_us = t_us;
+        while((t_us - start_us < segment_us) && (t_us < duration_ms * 1000)){
+            double s = (double)(t_us - start_us) / segment_us;
+            double jerk = s * s * s * (10 - 15 * s + 6 * s * s);  /* Minimum-jerk profile */
+
+            yaw = start_yaw + d_yaw * jerk;
+            pitch = start_pitch + d_pitch * jerk;
+            if(yaw > M_PI) yaw -= 2 * M_PI;
+            if(yaw < -M_PI) yaw += 2 * M_PI;
+
+            trace->samples.push_back(_toSample(t_us, yaw + noise(rng), roll, pitch + noise(rng)));
+
+            t_us += trace->sample_interval_us;
+            if(uniform(rng) < 0.02) t_us += (uint32_t)(1000 + 9000 * uniform(rng));  /* Late sample */
+        }
+    }
+}
@@ -0,0 +1,62 @@
+/* HEADMOUSE MOTION TRACE ************************************************
+ *
+ * Description: Compact binary format for recorded BNO055 quaternion
+ *              streams used by the host replay benchmarks.
+ *
+ *              File layout (little endian):
+ *                TraceHeader                 (16 bytes)
+ *                TraceSample[sample_count]   (12 bytes each)
+ *
+ ************************************************************************/
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+constexpr char TRACE_MAGIC[4] = {'H', 'M', 'T', 'R'};
+constexpr uint16_t TRACE_VERSION = 1;
+
+/*! *********************************************************
+* @brief Trace file header
+* @param magic File identifier "HMTR"
+* @param version Trace format version
+* @param sample_interval_us Nominal sample interval of the recording
+* @param sample_count Number of samples following the header
+*************************************************************/
+#pragma pack(push, 1)
+struct TraceHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t sample_interval_us;
+    uint32_t sample_count;
+};
+
+/*! *********************************************************
+* @brief Single recorded IMU sample
+* @param t_us Timestamp relative to the start of the recording
+* @param w,x,y,z Raw BNO055 quaternion (1 LSB = 2^-14)
+*************************************************************/
+struct TraceSample {
+    uint32_t t_us;
+    int16_t w;
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TraceHeader) == 16, "Trace header layout changed");
+static_assert(sizeof(TraceSample) == 12, "Trace sample layout changed");
+
+/*! *********************************************************
+* @brief Recorded motion trace
+*************************************************************/
+struct Trace {
+    uint32_t sample_interval_us = 10000;
+    std::vector<TraceSample> samples;
+};
+
+bool traceRead(const char* path, Trace* trace);
+bool traceWrite(const char* path, const Trace& trace);
+bool traceConvertCapture(const char* capture_path, Trace* trace);
+void traceSynthesize(uint32_t seed, uint32_t duration_ms, Trace* trace);
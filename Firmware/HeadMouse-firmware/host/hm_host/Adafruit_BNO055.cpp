@@ -0,0 +1,113 @@
+#include "Adafruit_BNO055.h"
+#include "host_sim.h"
+
+static constexpr double BNO055_QUAT_SCALE = 1.0 / (1 << 14);
+
+Adafruit_BNO055::Adafruit_BNO055(int32_t sensorID, uint8_t address, TwoWire* theWire)
+    : _sensor_id(sensorID), _address(address), _wire(theWire){
+}
+
+bool Adafruit_BNO055::begin(adafruit_bno055_opmode_t mode){
+    _mode = mode;
+    _page = 0;
+    if(_present && (_wire != nullptr)) _wire->hostAttachDevice(_address, this);
+    return _present;
+}
+
+/************************************************************
+ * @brief Inject a new fusion output sample.
+ *
+ * Raises the INT pin if the data ready interrupt is enabled.
+ *
+ * @param quat Raw quaternion (1 LSB = 2^-14).
+ *************************************************************/
+void Adafruit_BNO055::setRawQuat(const Bno055RawQuat& quat){
+    _raw_quat = quat;
+    if((_int_pin >= 0) && (_int_msk & _int_en & 0x01)) host::setPinLevel((uint8_t)_int_pin, 1);
+}
+
+/************************************************************
+ * @brief Get the current orientation quaternion.
+ *
+ * Scaled the same way as the Adafruit driver (1 LSB = 2^-14).
+ *
+ * @return Orientation quaternion.
+ *************************************************************/
+imu::Quaternion Adafruit_BNO055::getQuat(){
+    return imu::Quaternion(BNO055_QUAT_SCALE * _raw_quat.w, BNO055_QUAT_SCALE * _raw_quat.x,
+                           BNO055_QUAT_SCALE * _raw_quat.y, BNO055_QUAT_SCALE * _raw_quat.z);
+}
+
+/************************************************************
+ * @brief Get the current orientation as Euler angles [deg].
+ *
+ * @param event Sensor event to fill.
+ * @return Always returns true.
+ *************************************************************/
+bool Adafruit_BNO055::getEvent(sensors_event_t* event){
+    imu::Vector<3> euler = getQuat().toEuler();
+    euler.toDegrees();
+
+    *event = sensors_event_t();
+    event->sensor_id = _sensor_id;
+    event->orientation.x = (float)euler.x();
+    event->orientation.y = (float)euler.y();
+    event->orientation.z = (float)euler.z();
+    return true;
+}
+
+void Adafruit_BNO055::getCalibration(uint8_t* system, uint8_t* gyro, uint8_t* accel, uint8_t* mag){
+    if(system) *system = _calib[0];
+    if(gyro) *gyro = _calib[1];
+    if(accel) *accel = _calib[2];
+    if(mag) *mag = _calib[3];
+}
+
+void Adafruit_BNO055::setCalibration(uint8_t system, uint8_t gyro, uint8_t accel, uint8_t mag){
+    _calib[0] = system;
+    _calib[1] = gyro;
+    _calib[2] = accel;
+    _calib[3] = mag;
+}
+
+/************************************************************
+ * @brief Serve I2C register reads of the simulated sensor.
+ *
+ * Only the quaternion data registers (little endian w, x, y, z)
+ * are simulated.
+ *
+ * @return TRUE if all requested registers are simulated.
+ *************************************************************/
+bool Adafruit_BNO055::readRegisters(uint8_t reg, uint8_t* buffer, size_t len){
+    const int16_t quat[4] = {_raw_quat.w, _raw_quat.x, _raw_quat.y, _raw_quat.z};
+
+    for(size_t i=0; i<len; i++){
+        int offset = reg + (int)i - BNO055_QUATERNION_DATA_W_LSB_ADDR;
+        if((offset < 0) || (offset >= 8)) return false;
+
+        uint16_t value = (uint16_t)quat[offset / 2];
+        buffer[i] = (offset % 2) ? (uint8_t)(value >> 8) : (uint8_t)(value & 0xFF);
+    }
+    return true;
+}
+
+/************************************************************
+ * @brief Serve I2C register writes of the simulated sensor.
+ *
+ * Only the page select, the interrupt configuration (config 
+ * mode only) and the interrupt reset are simulated.
+ *
+ * @return TRUE if all written registers are simulated.
+ *************************************************************/
+bool Adafruit_BNO055::writeRegisters(uint8_t reg, const uint8_t* buffer, size_t len){
+    for(size_t i=0; i<len; i++, reg++){
+        if(reg == BNO055_PAGE_ID_ADDR) _page = buffer[i];
+        else if((_page == 1) && (_mode == OPERATION_MODE_CONFIG) && (reg == BNO055_INT_MSK_ADDR)) _int_msk = buffer[i];
+        else if((_page == 1) && (_mode == OPERATION_MODE_CONFIG) && (reg == BNO055_INT_EN_ADDR)) _int_en = buffer[i];
+        else if((_page == 0) && (reg == BNO055_SYS_TRIGGER_ADDR)){
+            if((buffer[i] & 0x40) && (_int_pin >= 0)) host::setPinLevel((uint8_t)_int_pin, 0);
+        }
+        else return false;
+    }
+    return true;
+}
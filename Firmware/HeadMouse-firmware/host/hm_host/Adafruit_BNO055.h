@@ -0,0 +1,74 @@
+/* ADAFRUIT BNO055 HOST SHIM *********************************************
+ *
+ * Description: Replacement of the Adafruit BNO055 driver. Orientation
+ *              data is injected through the setRaw...() hooks. The
+ *              quaternion data registers can also be read over the
+ *              simulated I2C bus. Each injected sample raises the INT
+ *              pin if the data ready interrupt is enabled; the pin is
+ *              latched until reset through SYS_TRIGGER.
+ *
+ ************************************************************************/
+#pragma once
+#include <stdint.h>
+#include "Wire.h"
+#include "Adafruit_Sensor.h"
+#include "utility/imumaths.h"
+
+#define BNO055_ADDRESS_A (0x28)
+#define BNO055_ADDRESS_B (0x29)
+#define BNO055_QUATERNION_DATA_W_LSB_ADDR (0x20)
+#define BNO055_PAGE_ID_ADDR (0x07)
+#define BNO055_INT_MSK_ADDR (0x0F)      /* Page 1 */
+#define BNO055_INT_EN_ADDR (0x10)       /* Page 1 */
+#define BNO055_SYS_TRIGGER_ADDR (0x3F)
+
+typedef enum {
+    OPERATION_MODE_CONFIG = 0x00,
+    OPERATION_MODE_IMUPLUS = 0x08,
+    OPERATION_MODE_NDOF = 0X0C
+} adafruit_bno055_opmode_t;
+
+/*! *********************************************************
+* @brief Raw BNO055 quaternion register content (1 LSB = 2^-14)
+*************************************************************/
+struct Bno055RawQuat {
+    int16_t w;
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+
+/*! *********************************************************
+* @brief Simulated BNO055 absolute orientation sensor
+*************************************************************/
+class Adafruit_BNO055 : public HostI2cDevice {
+private:
+    int32_t _sensor_id;
+    uint8_t _address;
+    TwoWire* _wire;
+    Bno055RawQuat _raw_quat = {1 << 14, 0, 0, 0};
+    uint8_t _calib[4] = {3, 3, 3, 3};   /* system, gyro, accel, mag */
+    bool _present = true;
+    adafruit_bno055_opmode_t _mode = OPERATION_MODE_CONFIG;
+    uint8_t _page = 0;
+    uint8_t _int_msk = 0;
+    uint8_t _int_en = 0;
+    int _int_pin = -1;
+
+public:
+    Adafruit_BNO055(int32_t sensorID = -1, uint8_t address = BNO055_ADDRESS_A, TwoWire* theWire = &Wire);
+
+    bool begin(adafruit_bno055_opmode_t mode = OPERATION_MODE_NDOF);
+    void setMode(adafruit_bno055_opmode_t mode) { _mode = mode; }
+    imu::Quaternion getQuat();
+    bool getEvent(sensors_event_t* event);
+    void getCalibration(uint8_t* system, uint8_t* gyro, uint8_t* accel, uint8_t* mag);
+
+    /* Host simulation hooks */
+    void setRawQuat(const Bno055RawQuat& quat);
+    void hostConnectIntPin(int pin) { _int_pin = pin; }
+    void setCalibration(uint8_t system, uint8_t gyro, uint8_t accel, uint8_t mag);
+    void setPresent(bool present) { _present = present; }
+    bool readRegisters(uint8_t reg, uint8_t* buffer, size_t len) override;
+    bool writeRegisters(uint8_t reg, const uint8_t* buffer, size_t len) override;
+};
@@ -0,0 +1,162 @@
+#include <Arduino.h>
+#include "host_sim.h"
+#include "ESP32TimerInterrupt.hpp"
+#include <atomic>
+
+HardwareSerial Serial;
+
+namespace{
+    std::atomic<uint64_t> _now_us{0};   // Read by the task pipeline threads
+    int _pin_level[host::PIN_COUNT];
+    int _analog_value[host::PIN_COUNT] = {0};
+    void (*_isr[host::PIN_COUNT])(void) = {nullptr};
+    int _isr_mode[host::PIN_COUNT] = {0};
+    bool _pins_initialized = false;
+
+    /* Unconnected inputs read HIGH, buttons are active low with pull-ups */
+    void _initPins(){
+        if(_pins_initialized) return;
+        for(int i=0; i<host::PIN_COUNT; i++){
+            _pin_level[i] = HIGH;
+        }
+        _pins_initialized = true;
+    }
+}
+
+/* HOST SIMULATION HOOKS ********************************************/
+
+/************************************************************
+ * @brief Get simulated time since start.
+ *
+ * @return Simulated time in microseconds.
+ *************************************************************/
+uint64_t host::nowMicros(){
+    return _now_us;
+}
+
+/************************************************************
+ * @brief Advance simulated time.
+ *
+ * All hardware timers which expire within the given interval
+ * are fired in chronological order.
+ *
+ * @param us Time to advance in microseconds.
+ *************************************************************/
+void host::advanceMicros(uint64_t us){
+    uint64_t target = _now_us + us;
+    uint64_t deadline = 0;
+
+    while(ESP32Timer::nextDeadline(&deadline) && (deadline <= target)){
+        _now_us = deadline;
+        ESP32Timer::fireExpired(_now_us);
+    }
+    _now_us = target;
+}
+
+/************************************************************
+ * @brief Reset simulated time to zero.
+ *************************************************************/
+void host::resetTime(){
+    _now_us = 0;
+}
+
+/************************************************************
+ * @brief Set the input level of a simulated GPIO.
+ *
+ * Attached pin change interrupts are called if the level change
+ * matches their trigger mode.
+ *
+ * @param pin GPIO number.
+ * @param level New pin level (LOW/HIGH).
+ *************************************************************/
+void host::setPinLevel(uint8_t pin, int level){
+    _initPins();
+    if(pin >= host::PIN_COUNT) return;
+
+    int old_level = _pin_level[pin];
+    _pin_level[pin] = level ? HIGH : LOW;
+
+    if((_isr[pin] == nullptr) || (old_level == _pin_level[pin])) return;
+    if((_isr_mode[pin] == CHANGE) ||
+       ((_isr_mode[pin] == FALLING) && (_pin_level[pin] == LOW)) ||
+       ((_isr_mode[pin] == RISING) && (_pin_level[pin] == HIGH))){
+        _isr[pin]();
+    }
+}
+
+/************************************************************
+ * @brief Get the current level of a simulated GPIO.
+ *
+ * @param pin GPIO number.
+ * @return Pin level (LOW/HIGH).
+ *************************************************************/
+int host::getPinLevel(uint8_t pin){
+    _initPins();
+    if(pin >= host::PIN_COUNT) return LOW;
+    return _pin_level[pin];
+}
+
+/************************************************************
+ * @brief Set the raw ADC reading of a simulated analog pin.
+ *
+ * @param pin GPIO number.
+ * @param value Raw 12 bit ADC value.
+ *************************************************************/
+void host::setAnalogValue(uint8_t pin, int value){
+    if(pin >= host::PIN_COUNT) return;
+    _analog_value[pin] = value;
+}
+
+/* ARDUINO API ******************************************************/
+
+void pinMode(uint8_t pin, uint8_t mode){
+    _initPins();
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val){
+    _initPins();
+    if(pin >= host::PIN_COUNT) return;
+    _pin_level[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin){
+    return host::getPinLevel(pin);
+}
+
+uint16_t analogRead(uint8_t pin){
+    if(pin >= host::PIN_COUNT) return 0;
+    return (uint16_t)_analog_value[pin];
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin){
+    return (uint32_t)analogRead(pin) * 3300 / 4095;     /* Ideal 12 bit ADC, 3.3 V full scale */
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode){
+    if(pin >= host::PIN_COUNT) return;
+    _isr[pin] = isr;
+    _isr_mode[pin] = mode;
+}
+
+void detachInterrupt(uint8_t pin){
+    if(pin >= host::PIN_COUNT) return;
+    _isr[pin] = nullptr;
+}
+
+unsigned long millis(){
+    return (unsigned long)(_now_us / 1000);
+}
+
+unsigned long micros(){
+    return (unsigned long)_now_us;
+}
+
+void delay(uint32_t ms){
+    host::advanceMicros((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us){
+    host::advanceMicros(us);
+}
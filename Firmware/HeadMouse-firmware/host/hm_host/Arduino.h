@@ -0,0 +1,55 @@
+/* ARDUINO HOST SHIM *****************************************************
+ *
+ * Description: Minimal Arduino core replacement so the HeadMouse library
+ *              compiles and runs as a Linux executable.
+ *
+ ************************************************************************/
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+
+#define IRAM_ATTR
+
+#define LOW             0x0
+#define HIGH            0x1
+
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define INPUT_PULLUP    0x05
+
+#define RISING          0x01
+#define FALLING         0x02
+#define CHANGE          0x03
+
+#define digitalPinToInterrupt(p)    (p)
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+/*! *********************************************************
+* @brief Serial port replacement, prints to stdout.
+*************************************************************/
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void print(const char* str) { fputs(str, stdout); }
+    void println(const char* str) { fputs(str, stdout); fputc('\n', stdout); }
+    explicit operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
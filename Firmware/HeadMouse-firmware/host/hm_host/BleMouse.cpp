@@ -0,0 +1,197 @@
+#include "BleMouse.h"
+
+BleMouse::BleMouse(std::string deviceName, std::string deviceManufacturer, uint8_t batteryLevel)
+  : _buttons(0), _connected(false), _report_count(0), _last_report{0}, _report_callback(nullptr), _abs_report_callback(nullptr),
+    _conn_interval(0), _conn_latency(0), _conn_timeout(0), _host_interval_min(6),
+    _host_wheel_multiplier(1){
+  this->deviceName = deviceName;
+  this->deviceManufacturer = deviceManufacturer;
+  this->batteryLevel = batteryLevel;
+}
+
+void BleMouse::begin(int core)
+{
+  (void)core;
+  setConnected(true);  // Simulated host pairs immediately
+}
+
+void BleMouse::end(void)
+{
+}
+
+void BleMouse::connectNewDevice(void)
+{
+  setConnected(false);
+}
+
+void BleMouse::setConnected(bool connected)
+{
+  if (connected == _connected)
+    return;
+  _connected = connected;
+  _conn_interval = connected ? _host_interval_min : 0;
+  _conn_latency = 0;
+  _conn_timeout = connected ? 400 : 0;   // 4 s
+}
+
+void BleMouse::click(uint8_t b)
+{
+  _buttons = b;
+  move(0,0,0,0);
+  _buttons = 0;
+  move(0,0,0,0);
+}
+
+void BleMouse::move(signed char x, signed char y, signed char wheel, signed char hWheel)
+{
+#ifdef HM_HID_16BIT
+  move((int)x, (int)y, wheel, hWheel);
+#else
+  if (this->isConnected())
+  {
+    uint8_t m[5];
+    m[0] = _buttons;
+    m[1] = x;
+    m[2] = y;
+    m[3] = wheel;
+    m[4] = hWheel;
+    rawAction(m, 5);
+  }
+#endif
+}
+
+#ifdef HM_HID_16BIT
+void BleMouse::move(int x, int y, signed char wheel, signed char hWheel)
+{
+  if (this->isConnected())
+  {
+    int16_t x16 = (x > 32767) ? 32767 : (x < -32767) ? -32767 : (int16_t)x;
+    int16_t y16 = (y > 32767) ? 32767 : (y < -32767) ? -32767 : (int16_t)y;
+    uint8_t m[7];
+    m[0] = _buttons;
+    m[1] = (uint8_t)(x16 & 0xff);
+    m[2] = (uint8_t)((uint16_t)x16 >> 8);
+    m[3] = (uint8_t)(y16 & 0xff);
+    m[4] = (uint8_t)((uint16_t)y16 >> 8);
+    m[5] = wheel;
+    m[6] = hWheel;
+    rawAction(m, 7);
+  }
+}
+#endif
+
+void BleMouse::rawAction(uint8_t msg[], char msgSize, bool isAbsolute)
+{
+  host_report_callback callback = isAbsolute ? _abs_report_callback : _report_callback;
+  memcpy(_last_report, msg, (msgSize < (char)sizeof(_last_report)) ? msgSize : sizeof(_last_report));
+  _report_count++;
+  if (callback != nullptr)
+    callback(msg, msgSize);
+}
+
+void BleMouse::report(uint8_t b, int x, int y, signed char wheel, signed char hWheel)
+{
+  _buttons = b;
+#ifdef HM_HID_16BIT
+  move(x, y, wheel, hWheel);
+#else
+  signed char x8 = (x > 127) ? 127 : (x < -127) ? -127 : (signed char)x;
+  signed char y8 = (y > 127) ? 127 : (y < -127) ? -127 : (signed char)y;
+  move(x8, y8, wheel, hWheel);
+#endif
+}
+
+#ifdef HM_HID_ABSOLUTE
+void BleMouse::moveTo(int x, int y, signed char wheel, signed char hWheel)
+{
+  if (this->isConnected())
+  {
+    uint16_t x16 = (x > ABS_POSITION_MAX) ? ABS_POSITION_MAX : (x < 0) ? 0 : (uint16_t)x;
+    uint16_t y16 = (y > ABS_POSITION_MAX) ? ABS_POSITION_MAX : (y < 0) ? 0 : (uint16_t)y;
+    uint8_t m[7];
+    m[0] = _buttons;
+    m[1] = (uint8_t)(x16 & 0xff);
+    m[2] = (uint8_t)(x16 >> 8);
+    m[3] = (uint8_t)(y16 & 0xff);
+    m[4] = (uint8_t)(y16 >> 8);
+    m[5] = wheel;
+    m[6] = hWheel;
+    rawAction(m, 7, true);
+  }
+}
+
+void BleMouse::reportAbsolute(uint8_t b, int x, int y, signed char wheel, signed char hWheel)
+{
+  _buttons = b;
+  moveTo(x, y, wheel, hWheel);
+}
+#endif
+
+void BleMouse::buttons(uint8_t b)
+{
+  if (b != _buttons)
+  {
+    _buttons = b;
+    move(0,0,0,0);
+  }
+}
+
+void BleMouse::press(uint8_t b)
+{
+  buttons(_buttons | b);
+}
+
+void BleMouse::release(uint8_t b)
+{
+  buttons(_buttons & ~b);
+}
+
+bool BleMouse::isPressed(uint8_t b)
+{
+  if ((b & _buttons) > 0)
+    return true;
+  return false;
+}
+
+bool BleMouse::isConnected(void) {
+  return _connected;
+}
+
+void BleMouse::requestConnParams(uint16_t minInterval, uint16_t maxInterval, uint16_t latency, uint16_t timeout)
+{
+  if (!_connected || (_host_interval_min > maxInterval))
+    return;   // rejected by the simulated host
+  _conn_interval = (minInterval > _host_interval_min) ? minInterval : _host_interval_min;
+  _conn_latency = latency;
+  _conn_timeout = timeout;
+}
+
+uint8_t BleMouse::getWheelMultiplier(void)
+{
+#ifdef HM_HID_HIRES_WHEEL
+  if (this->isConnected())
+    return _host_wheel_multiplier;
+#endif
+  return 1;
+}
+
+uint8_t BleMouse::getPanMultiplier(void)
+{
+  return getWheelMultiplier();
+}
+
+uint16_t BleMouse::getConnInterval(void) {
+  return _conn_interval;
+}
+
+uint16_t BleMouse::getConnLatency(void) {
+  return _conn_latency;
+}
+
+uint16_t BleMouse::getConnTimeout(void) {
+  return _conn_timeout;
+}
+
+void BleMouse::setBatteryLevel(uint8_t level) {
+  this->batteryLevel = level;
+}
@@ -0,0 +1,82 @@
+/* BLE MOUSE HOST SHIM ***************************************************
+ *
+ * Description: Replacement of the ESP32 BLE Mouse library. HID reports
+ *              are counted and handed to an optional host callback
+ *              instead of being notified over BLE. Connection parameter
+ *              requests are granted at once, limited to the shortest
+ *              interval of the simulated host.
+ *
+ ************************************************************************/
+#ifndef ESP32_BLE_MOUSE_H
+#define ESP32_BLE_MOUSE_H
+#include <Arduino.h>
+#include <string>
+
+#define MOUSE_NONE 0
+#define MOUSE_LEFT 1
+#define MOUSE_RIGHT 2
+#define MOUSE_MIDDLE 4
+#define MOUSE_BACK 8
+#define MOUSE_FORWARD 16
+#define MOUSE_ALL (MOUSE_LEFT | MOUSE_RIGHT | MOUSE_MIDDLE) # For compatibility with the Mouse library
+#define ABS_POSITION_MAX 32767  // logical maximum of the absolute pointer report, mapped to the whole screen
+#define WHEEL_HIRES_MULTIPLIER 8  // wheel counts per detent if the host enables the resolution multiplier
+
+typedef void (*host_report_callback)(const uint8_t* report, size_t len);
+
+class BleMouse {
+private:
+  uint8_t _buttons;
+  bool _connected;
+  uint32_t _report_count;
+  uint8_t _last_report[7];
+  host_report_callback _report_callback;
+  host_report_callback _abs_report_callback;
+  uint16_t _conn_interval;
+  uint16_t _conn_latency;
+  uint16_t _conn_timeout;
+  uint16_t _host_interval_min;   // Simulated host: shortest interval it grants, also its initial one
+  uint8_t _host_wheel_multiplier; // Simulated host: resolution multiplier it sets
+  void buttons(uint8_t b);
+  void rawAction(uint8_t msg[], char msgSize, bool isAbsolute = false);
+public:
+  BleMouse(std::string deviceName = "ESP32 Bluetooth Mouse", std::string deviceManufacturer = "Espressif", uint8_t batteryLevel = 100);
+  void begin(int core = -1);  // core is ignored on the host
+  void end(void);
+  void connectNewDevice(void);
+  void click(uint8_t b = MOUSE_LEFT);
+  void move(signed char x, signed char y, signed char wheel = 0, signed char hWheel = 0);
+#ifdef HM_HID_16BIT
+  void move(int x, int y, signed char wheel = 0, signed char hWheel = 0);  // 16 bit X/Y, saturated to +-32767
+#endif
+  void report(uint8_t b, int x, int y, signed char wheel = 0, signed char hWheel = 0); // one report with button state, X/Y saturated
+#ifdef HM_HID_ABSOLUTE
+  void moveTo(int x, int y, signed char wheel = 0, signed char hWheel = 0);  // absolute position 0..ABS_POSITION_MAX
+  void reportAbsolute(uint8_t b, int x, int y, signed char wheel = 0, signed char hWheel = 0);
+#endif
+  void press(uint8_t b = MOUSE_LEFT);   // press LEFT by default
+  void release(uint8_t b = MOUSE_LEFT); // release LEFT by default
+  bool isPressed(uint8_t b = MOUSE_LEFT); // check LEFT by default
+  bool isConnected(void);
+  void requestConnParams(uint16_t minInterval, uint16_t maxInterval, uint16_t latency, uint16_t timeout); // intervals [1.25 ms], timeout [10 ms]
+  uint16_t getConnInterval(void);   // negotiated interval [1.25 ms], 0 if not connected
+  uint16_t getConnLatency(void);    // negotiated slave latency [connection events]
+  uint16_t getConnTimeout(void);    // negotiated supervision timeout [10 ms]
+  uint8_t getWheelMultiplier(void); // wheel counts per detent set by the host, 1 without HM_HID_HIRES_WHEEL
+  uint8_t getPanMultiplier(void);   // horizontal wheel counts per detent set by the host
+  void setBatteryLevel(uint8_t level);
+  uint8_t batteryLevel;
+  std::string deviceManufacturer;
+  std::string deviceName;
+
+  /* Host simulation hooks */
+  void setConnected(bool connected);  // connection parameters start at the host defaults, reset on disconnect
+  void setHostIntervalMin(uint16_t interval) { _host_interval_min = interval; }
+  void setHostWheelMultiplier(uint8_t multiplier) { _host_wheel_multiplier = multiplier; }
+  void setReportCallback(host_report_callback callback) { _report_callback = callback; }
+  void setAbsReportCallback(host_report_callback callback) { _abs_report_callback = callback; }
+  uint32_t getReportCount(void) { return _report_count; }
+  const uint8_t* getLastReport(void) { return _last_report; }
+};
+
+#endif // ESP32_BLE_MOUSE_H
@@ -0,0 +1,84 @@
+#include "ESP32TimerInterrupt.hpp"
+#include "host_sim.h"
+
+ESP32Timer* ESP32Timer::_timers[HOST_TIMER_COUNT] = {nullptr};
+
+ESP32Timer::ESP32Timer(uint8_t timer_no) : _timer_no(timer_no){
+    if(_timer_no < HOST_TIMER_COUNT){
+        _timers[_timer_no] = this;
+    }
+}
+
+/************************************************************
+ * @brief Attach a periodic callback and start the timer.
+ *
+ * @param interval_us Timer period in microseconds.
+ * @param callback Function called on every timer expiry.
+ * @return TRUE if the timer could be started, FALSE otherwise.
+ *************************************************************/
+bool ESP32Timer::attachInterruptInterval(uint64_t interval_us, esp32_timer_callback callback){
+    if((interval_us == 0) || (callback == nullptr) || (_timer_no >= HOST_TIMER_COUNT)) return false;
+
+    _interval_us = interval_us;
+    _callback = callback;
+    restartTimer();
+    return true;
+}
+
+void ESP32Timer::detachInterrupt(){
+    _enabled = false;
+    _callback = nullptr;
+}
+
+void ESP32Timer::stopTimer(){
+    _enabled = false;
+}
+
+void ESP32Timer::restartTimer(){
+    _deadline_us = host::nowMicros() + _interval_us;
+    _enabled = true;
+}
+
+void ESP32Timer::enableTimer(){
+    if(!_enabled) restartTimer();
+}
+
+void ESP32Timer::disableTimer(){
+    _enabled = false;
+}
+
+/************************************************************
+ * @brief Get the earliest deadline of all running timers.
+ *
+ * @param deadline_us Output for the earliest deadline.
+ * @return TRUE if any timer is running, FALSE otherwise.
+ *************************************************************/
+bool ESP32Timer::nextDeadline(uint64_t* deadline_us){
+    bool found = false;
+
+    for(int i=0; i<HOST_TIMER_COUNT; i++){
+        ESP32Timer* timer = _timers[i];
+        if((timer == nullptr) || !timer->_enabled || (timer->_callback == nullptr)) continue;
+        if(!found || (timer->_deadline_us < *deadline_us)){
+            *deadline_us = timer->_deadline_us;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/************************************************************
+ * @brief Call the callbacks of all expired timers.
+ *
+ * @param now_us Current simulated time in microseconds.
+ *************************************************************/
+void ESP32Timer::fireExpired(uint64_t now_us){
+    for(int i=0; i<HOST_TIMER_COUNT; i++){
+        ESP32Timer* timer = _timers[i];
+        if((timer == nullptr) || !timer->_enabled || (timer->_callback == nullptr)) continue;
+        if(timer->_deadline_us <= now_us){
+            timer->_deadline_us += timer->_interval_us;
+            timer->_callback((void*)(uintptr_t)timer->_timer_no);
+        }
+    }
+}
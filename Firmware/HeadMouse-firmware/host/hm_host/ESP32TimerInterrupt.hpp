@@ -0,0 +1,40 @@
+/* ESP32 TIMER INTERRUPT HOST SHIM ***************************************
+ *
+ * Description: Replacement of the ESP32TimerInterrupt library. Timers are
+ *              driven by the simulated host clock (host::advanceMicros()).
+ *
+ ************************************************************************/
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+typedef bool (*esp32_timer_callback)(void* param);
+
+constexpr uint8_t HOST_TIMER_COUNT = 4;
+
+/*! *********************************************************
+* @brief Simulated hardware timer
+*************************************************************/
+class ESP32Timer {
+private:
+    uint8_t _timer_no;
+    uint64_t _interval_us = 0;
+    std::atomic<uint64_t> _deadline_us{0};  // Timers are also started and stopped by pipeline task threads
+    std::atomic<bool> _enabled{false};
+    esp32_timer_callback _callback = nullptr;
+
+    static ESP32Timer* _timers[HOST_TIMER_COUNT];
+
+public:
+    ESP32Timer(uint8_t timer_no);
+
+    bool attachInterruptInterval(uint64_t interval_us, esp32_timer_callback callback);
+    void detachInterrupt();
+    void stopTimer();
+    void restartTimer();
+    void enableTimer();
+    void disableTimer();
+
+    static bool nextDeadline(uint64_t* deadline_us);
+    static void fireExpired(uint64_t now_us);
+};
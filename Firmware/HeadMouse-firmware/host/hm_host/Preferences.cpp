@@ -0,0 +1,87 @@
+#include "Preferences.h"
+#include <string.h>
+
+/************************************************************
+ * @brief Get the process wide key/value storage.
+ *
+ * @return Map of "namespace/key" to stored bytes.
+ *************************************************************/
+std::map<std::string, std::vector<uint8_t>>& Preferences::_storage(){
+    static std::map<std::string, std::vector<uint8_t>> storage;
+    return storage;
+}
+
+std::string Preferences::_key(const char* key) const{
+    return _namespace + "/" + key;
+}
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partition_label){
+    (void)partition_label;
+    if(name == nullptr) return false;
+    _namespace = name;
+    _read_only = readOnly;
+    _started = true;
+    return true;
+}
+
+void Preferences::end(){
+    _started = false;
+}
+
+bool Preferences::clear(){
+    if(!_started || _read_only) return false;
+
+    std::string prefix = _namespace + "/";
+    auto& storage = _storage();
+    for(auto it = storage.begin(); it != storage.end();){
+        if(it->first.compare(0, prefix.size(), prefix) == 0) it = storage.erase(it);
+        else ++it;
+    }
+    return true;
+}
+
+bool Preferences::remove(const char* key){
+    if(!_started || _read_only) return false;
+    return _storage().erase(_key(key)) > 0;
+}
+
+bool Preferences::isKey(const char* key){
+    if(!_started) return false;
+    return _storage().count(_key(key)) > 0;
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value){
+    return putBytes(key, &value, sizeof(value));
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue){
+    uint32_t value = defaultValue;
+    if(getBytesLength(key) != sizeof(value)) return defaultValue;
+    getBytes(key, &value, sizeof(value));
+    return value;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len){
+    if(!_started || _read_only || (key == nullptr)) return 0;
+
+    const uint8_t* bytes = (const uint8_t*)value;
+    _storage()[_key(key)] = std::vector<uint8_t>(bytes, bytes + len);
+    return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen){
+    if(!_started) return 0;
+
+    auto it = _storage().find(_key(key));
+    if((it == _storage().end()) || (it->second.size() > maxLen)) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key){
+    if(!_started) return 0;
+
+    auto it = _storage().find(_key(key));
+    if(it == _storage().end()) return 0;
+    return it->second.size();
+}
@@ -0,0 +1,38 @@
+/* PREFERENCES HOST SHIM *************************************************
+ *
+ * Description: Replacement of the ESP32 non-volatile Preferences storage.
+ *              Values are kept in RAM for the lifetime of the process.
+ *
+ ************************************************************************/
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/*! *********************************************************
+* @brief Simulated non-volatile key/value storage
+*************************************************************/
+class Preferences {
+private:
+    std::string _namespace;
+    bool _read_only = false;
+    bool _started = false;
+
+    static std::map<std::string, std::vector<uint8_t>>& _storage();
+    std::string _key(const char* key) const;
+
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partition_label = nullptr);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putUInt(const char* key, uint32_t value);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    size_t putBytes(const char* key, const void* value, size_t len);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+    size_t getBytesLength(const char* key);
+};
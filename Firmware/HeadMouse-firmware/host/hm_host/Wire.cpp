@@ -0,0 +1,85 @@
+#include "Wire.h"
+
+TwoWire Wire;
+
+HostI2cDevice* TwoWire::_findDevice(uint8_t address){
+    for(int i=0; i<HOST_I2C_DEVICE_COUNT; i++){
+        if((_device[i] != nullptr) && (_device_address[i] == address)) return _device[i];
+    }
+    return nullptr;
+}
+
+void TwoWire::beginTransmission(uint8_t address){
+    _tx_address = address;
+    _tx_has_register = false;
+    _tx_length = 0;
+}
+
+/************************************************************
+ * @brief Write a byte to the current transmission.
+ *
+ * The first byte selects the register, the following bytes are
+ * written to the device starting at this register.
+ *************************************************************/
+size_t TwoWire::write(uint8_t data){
+    if(!_tx_has_register){
+        _tx_register = data;
+        _tx_has_register = true;
+    }
+    else if(_tx_length < HOST_I2C_BUFFER_LENGTH){
+        _tx_buffer[_tx_length++] = data;
+    }
+    else return 0;
+    return 1;
+}
+
+/************************************************************
+ * @brief End the current transmission.
+ *
+ * @return 0 on success, 2 if no device acknowledged the address,
+ *         3 if the device did not accept the written data.
+ *************************************************************/
+uint8_t TwoWire::endTransmission(bool sendStop){
+    (void)sendStop;
+    HostI2cDevice* device = _findDevice(_tx_address);
+
+    if(device == nullptr) return 2;
+    if((_tx_length > 0) && !device->writeRegisters(_tx_register, _tx_buffer, _tx_length)) return 3;
+    return 0;
+}
+
+/************************************************************
+ * @brief Read bytes starting at the previously written register.
+ *
+ * @return Number of bytes received.
+ *************************************************************/
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity){
+    HostI2cDevice* device = _findDevice(address);
+    _rx_index = 0;
+    _rx_length = 0;
+
+    if((device == nullptr) || (quantity > HOST_I2C_BUFFER_LENGTH)) return 0;
+    if(!device->readRegisters(_tx_register, _rx_buffer, quantity)) return 0;
+
+    _rx_length = quantity;
+    return quantity;
+}
+
+int TwoWire::available(){
+    return _rx_length - _rx_index;
+}
+
+int TwoWire::read(){
+    if(_rx_index >= _rx_length) return -1;
+    return _rx_buffer[_rx_index++];
+}
+
+void TwoWire::hostAttachDevice(uint8_t address, HostI2cDevice* device){
+    for(int i=0; i<HOST_I2C_DEVICE_COUNT; i++){
+        if((_device[i] == nullptr) || (_device_address[i] == address)){
+            _device[i] = device;
+            _device_address[i] = address;
+            return;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/* WIRE HOST SHIM ********************************************************
+ *
+ * Description: Replacement of the Arduino I2C (Wire) interface. Register
+ *              reads and writes are served by simulated devices attached
+ *              to the bus.
+ *
+ ************************************************************************/
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+constexpr uint8_t HOST_I2C_BUFFER_LENGTH = 32;
+constexpr uint8_t HOST_I2C_DEVICE_COUNT = 4;
+
+/*! *********************************************************
+* @brief Interface of a simulated I2C device
+*************************************************************/
+class HostI2cDevice {
+public:
+    virtual bool readRegisters(uint8_t reg, uint8_t* buffer, size_t len) = 0;
+    virtual bool writeRegisters(uint8_t reg, const uint8_t* buffer, size_t len) { (void)reg; (void)buffer; (void)len; return false; }
+};
+
+/*! *********************************************************
+* @brief Simulated I2C bus
+*************************************************************/
+class TwoWire {
+private:
+    int _sda = -1;
+    int _scl = -1;
+    uint8_t _tx_address = 0;
+    uint8_t _tx_register = 0;
+    bool _tx_has_register = false;
+    uint8_t _tx_buffer[HOST_I2C_BUFFER_LENGTH];
+    uint8_t _tx_length = 0;
+    uint8_t _rx_buffer[HOST_I2C_BUFFER_LENGTH];
+    uint8_t _rx_length = 0;
+    uint8_t _rx_index = 0;
+    uint8_t _device_address[HOST_I2C_DEVICE_COUNT] = {0};
+    HostI2cDevice* _device[HOST_I2C_DEVICE_COUNT] = {nullptr};
+
+    HostI2cDevice* _findDevice(uint8_t address);
+
+public:
+    bool setPins(int sda, int scl) { _sda = sda; _scl = scl; return true; }
+    bool begin() { return true; }
+    bool setClock(uint32_t frequency) { (void)frequency; return true; }
+    void end() {}
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity);
+    int available();
+    int read();
+
+    /* Host simulation hooks */
+    void hostAttachDevice(uint8_t address, HostI2cDevice* device);
+};
+
+extern TwoWire Wire;
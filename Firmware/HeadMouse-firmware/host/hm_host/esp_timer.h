@@ -0,0 +1,12 @@
+/* ESP TIMER HOST SHIM ***************************************************
+ *
+ * Description: esp_timer_get_time() on the simulated host clock.
+ *
+ ************************************************************************/
+#pragma once
+#include <stdint.h>
+#include "host_sim.h"
+
+inline int64_t esp_timer_get_time(){
+    return (int64_t)host::nowMicros();
+}
@@ -0,0 +1,28 @@
+/* HOST MAIN *************************************************************
+ *
+ * Description: Arduino style entry point of the native environment. Runs
+ *              setup() once and loop() for a given simulated run time.
+ *              Usage: program [run_time_ms]
+ *
+ ************************************************************************/
+#include <Arduino.h>
+#include "host_sim.h"
+
+static constexpr uint32_t HOST_DEFAULT_RUN_MS = 10000;  // Simulated run time if not given as argument
+static constexpr uint32_t HOST_LOOP_STEP_US = 1000;     // Simulated time passing per loop() call
+
+void setup();
+void loop();
+
+int main(int argc, char** argv){
+    uint32_t run_ms = HOST_DEFAULT_RUN_MS;
+    if(argc > 1) run_ms = (uint32_t)strtoul(argv[1], nullptr, 10);
+
+    setup();
+    while(host::nowMicros() < (uint64_t)run_ms * 1000){
+        loop();
+        host::advanceMicros(HOST_LOOP_STEP_US);
+    }
+
+    return 0;
+}
@@ -0,0 +1,20 @@
+/* HOST SIMULATION *******************************************************
+ *
+ * Description: Simulation hooks of the host (Linux) shims. Used by the
+ *              native environment to drive time, GPIOs and ADC inputs.
+ *
+ ************************************************************************/
+#pragma once
+#include <stdint.h>
+
+namespace host{
+    constexpr uint8_t PIN_COUNT = 49;   /* ESP32-S3 GPIO0..GPIO48 */
+
+    uint64_t nowMicros();
+    void advanceMicros(uint64_t us);
+    void resetTime();
+
+    void setPinLevel(uint8_t pin, int level);
+    int getPinLevel(uint8_t pin);
+    void setAnalogValue(uint8_t pin, int value);
+}
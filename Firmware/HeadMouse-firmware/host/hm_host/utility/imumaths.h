@@ -0,0 +1,113 @@
+/* IMUMATHS HOST SHIM ****************************************************
+ *
+ * Description: Subset of Adafruit's imumaths (vector/quaternion) used by
+ *              the HeadMouse library. Formulas match the Adafruit BNO055
+ *              library so host results equal the target results.
+ *
+ ************************************************************************/
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+namespace imu{
+
+/*! *********************************************************
+* @brief Fixed size vector of doubles
+*************************************************************/
+template <uint8_t N> class Vector {
+private:
+    double p_vec[N];
+
+public:
+    Vector() { for(int i=0; i<N; i++) p_vec[i] = 0; }
+    Vector(double a, double b = 0, double c = 0){
+        double init[3] = {a, b, c};
+        for(int i=0; i<N; i++) p_vec[i] = (i < 3) ? init[i] : 0;
+    }
+
+    double& operator[](int n) { return p_vec[n]; }
+    double operator[](int n) const { return p_vec[n]; }
+
+    double& x() { return p_vec[0]; }
+    double& y() { return p_vec[1]; }
+    double& z() { return p_vec[2]; }
+    double x() const { return p_vec[0]; }
+    double y() const { return p_vec[1]; }
+    double z() const { return p_vec[2]; }
+
+    double magnitude() const {
+        double res = 0;
+        for(int i=0; i<N; i++) res += p_vec[i] * p_vec[i];
+        return sqrt(res);
+    }
+
+    Vector scale(double scalar) const {
+        Vector ret;
+        for(int i=0; i<N; i++) ret.p_vec[i] = p_vec[i] * scalar;
+        return ret;
+    }
+
+    void toDegrees() { for(int i=0; i<N; i++) p_vec[i] *= 57.2957795131; }
+    void toRadians() { for(int i=0; i<N; i++) p_vec[i] *= 0.01745329251; }
+};
+
+/*! *********************************************************
+* @brief Quaternion (w, x, y, z) of doubles
+*************************************************************/
+class Quaternion {
+private:
+    double _w, _x, _y, _z;
+
+public:
+    Quaternion() : _w(1.0), _x(0.0), _y(0.0), _z(0.0) {}
+    Quaternion(double w, double x, double y, double z) : _w(w), _x(x), _y(y), _z(z) {}
+
+    double& w() { return _w; }
+    double& x() { return _x; }
+    double& y() { return _y; }
+    double& z() { return _z; }
+    double w() const { return _w; }
+    double x() const { return _x; }
+    double y() const { return _y; }
+    double z() const { return _z; }
+
+    double magnitude() const {
+        return sqrt(_w * _w + _x * _x + _y * _y + _z * _z);
+    }
+
+    void normalize() {
+        double mag = magnitude();
+        *this = this->scale(1 / mag);
+    }
+
+    Quaternion conjugate() const {
+        return Quaternion(_w, -_x, -_y, -_z);
+    }
+
+    Quaternion operator*(const Quaternion& q) const {
+        return Quaternion(_w * q._w - _x * q._x - _y * q._y - _z * q._z,
+                          _w * q._x + _x * q._w + _y * q._z - _z * q._y,
+                          _w * q._y - _x * q._z + _y * q._w + _z * q._x,
+                          _w * q._z + _x * q._y - _y * q._x + _z * q._w);
+    }
+
+    Quaternion scale(double scalar) const {
+        return Quaternion(_w * scalar, _x * scalar, _y * scalar, _z * scalar);
+    }
+
+    Vector<3> toEuler() const {
+        Vector<3> ret;
+        double sqw = _w * _w;
+        double sqx = _x * _x;
+        double sqy = _y * _y;
+        double sqz = _z * _z;
+
+        ret.x() = atan2(2.0 * (_x * _y + _z * _w), (sqx - sqy - sqz + sqw));
+        ret.y() = asin(-2.0 * (_x * _z - _y * _w) / (sqx + sqy + sqz + sqw));
+        ret.z() = atan2(2.0 * (_y * _z + _x * _w), (-sqx - sqy + sqz + sqw));
+
+        return ret;
+    }
+};
+
+} // namespace imu
@@ -1,3 +1,4 @@
+#include <string.h>
 #include "BleConnectionStatus.h"
 
 BleConnectionStatus::BleConnectionStatus(void) {
@@ -8,12 +9,47 @@ void BleConnectionStatus::onConnect(BLEServer* pServer)
   this->connected = true;
   BLE2902* desc = (BLE2902*)this->inputMouse->getDescriptorByUUID(BLEUUID((uint16_t)0x2902));
   desc->setNotifications(true);
+  if (this->inputAbsolute != nullptr)
+  {
+    desc = (BLE2902*)this->inputAbsolute->getDescriptorByUUID(BLEUUID((uint16_t)0x2902));
+    desc->setNotifications(true);
+  }
+}
+
+void BleConnectionStatus::onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param)
+{
+  memcpy(this->remoteBda, param->connect.remote_bda, sizeof(esp_bd_addr_t));
+  this->connInterval = param->connect.conn_params.interval;
+  this->connLatency = param->connect.conn_params.latency;
+  this->connTimeout = param->connect.conn_params.timeout;
+}
+
+void BleConnectionStatus::onConnParamsUpdate(esp_ble_gap_cb_param_t* param)
+{
+  if ((param->update_conn_params.status != ESP_BT_STATUS_SUCCESS) || !this->connected)
+    return;
+  this->connInterval = param->update_conn_params.conn_int;
+  this->connLatency = param->update_conn_params.latency;
+  this->connTimeout = param->update_conn_params.timeout;
 }
 
 void BleConnectionStatus::onDisconnect(BLEServer* pServer)
 {
   this->connected = false;
+  this->connInterval = 0;   // the next host negotiates its own parameters
+  this->connLatency = 0;
+  this->connTimeout = 0;
+  if (this->featureWheel != nullptr)
+  {
+    uint8_t multipliers = 0;  // the next host sets its own
+    this->featureWheel->setValue(&multipliers, 1);
+  }
   BLE2902* desc = (BLE2902*)this->inputMouse->getDescriptorByUUID(BLEUUID((uint16_t)0x2902));
   desc->setNotifications(false);
+  if (this->inputAbsolute != nullptr)
+  {
+    desc = (BLE2902*)this->inputAbsolute->getDescriptorByUUID(BLEUUID((uint16_t)0x2902));
+    desc->setNotifications(false);
+  }
   pServer->startAdvertising();
 }
@@ -13,8 +13,16 @@ public:
   BleConnectionStatus(void);
   bool connected = false;
   void onConnect(BLEServer* pServer);
+  void onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param);
   void onDisconnect(BLEServer* pServer);
+  void onConnParamsUpdate(esp_ble_gap_cb_param_t* param);
   BLECharacteristic* inputMouse;
+  BLECharacteristic* inputAbsolute = nullptr;  // absolute pointer report, if built with HM_HID_ABSOLUTE
+  BLECharacteristic* featureWheel = nullptr;   // resolution multipliers, if built with HM_HID_HIRES_WHEEL
+  esp_bd_addr_t remoteBda = {0};
+  uint16_t connInterval = 0;  // negotiated connection parameters: interval [1.25 ms], 0 if not connected
+  uint16_t connLatency = 0;   // slave latency [connection events]
+  uint16_t connTimeout = 0;   // supervision timeout [10 ms]
 };
 
 #endif // CONFIG_BT_ENABLED
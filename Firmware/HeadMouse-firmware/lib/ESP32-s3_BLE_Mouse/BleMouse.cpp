@@ -21,11 +21,15 @@
 
 BLEAdvertising* BleMouse::pAdvertising = nullptr;
 BLEServer* BleMouse::pServer = nullptr;
+static BleConnectionStatus* gapConnectionStatus = nullptr;  // connection of the GAP handler
 
 static const uint8_t _hidReportDescriptor[] = {
   USAGE_PAGE(1),       0x01, // USAGE_PAGE (Generic Desktop)
   USAGE(1),            0x02, // USAGE (Mouse)
   COLLECTION(1),       0x01, // COLLECTION (Application)
+#ifdef HM_HID_ABSOLUTE
+  REPORT_ID(1),        0x01, //   REPORT_ID (1)
+#endif
   USAGE(1),            0x01, //   USAGE (Pointer)
   COLLECTION(1),       0x00, //   COLLECTION (Physical)
   // ------------------------------------------------- Buttons (Left, Right, Middle, Back, Forward)
@@ -41,6 +45,27 @@ static const uint8_t _hidReportDescriptor[] = {
   REPORT_SIZE(1),      0x03, //     REPORT_SIZE (3)
   REPORT_COUNT(1),     0x01, //     REPORT_COUNT (1)
   HIDINPUT(1),         0x03, //     INPUT (Constant, Variable, Absolute) ;3 bit padding
+#if defined(HM_HID_16BIT)
+  // ------------------------------------------------- X/Y position (16 bit)
+  USAGE_PAGE(1),       0x01, //     USAGE_PAGE (Generic Desktop)
+  USAGE(1),            0x30, //     USAGE (X)
+  USAGE(1),            0x31, //     USAGE (Y)
+  LOGICAL_MINIMUM(2),  0x01, 0x80, // LOGICAL_MINIMUM (-32767)
+  LOGICAL_MAXIMUM(2),  0xff, 0x7f, // LOGICAL_MAXIMUM (32767)
+  REPORT_SIZE(1),      0x10, //     REPORT_SIZE (16)
+  REPORT_COUNT(1),     0x02, //     REPORT_COUNT (2)
+  HIDINPUT(1),         0x06, //     INPUT (Data, Variable, Relative) ;4 bytes (X,Y)
+#elif defined(HM_HID_HIRES_WHEEL)
+  // ------------------------------------------------- X/Y position
+  USAGE_PAGE(1),       0x01, //     USAGE_PAGE (Generic Desktop)
+  USAGE(1),            0x30, //     USAGE (X)
+  USAGE(1),            0x31, //     USAGE (Y)
+  LOGICAL_MINIMUM(1),  0x81, //     LOGICAL_MINIMUM (-127)
+  LOGICAL_MAXIMUM(1),  0x7f, //     LOGICAL_MAXIMUM (127)
+  REPORT_SIZE(1),      0x08, //     REPORT_SIZE (8)
+  REPORT_COUNT(1),     0x02, //     REPORT_COUNT (2)
+  HIDINPUT(1),         0x06, //     INPUT (Data, Variable, Relative) ;2 bytes (X,Y)
+#else
   // ------------------------------------------------- X/Y position, Wheel
   USAGE_PAGE(1),       0x01, //     USAGE_PAGE (Generic Desktop)
   USAGE(1),            0x30, //     USAGE (X)
@@ -51,6 +76,61 @@ static const uint8_t _hidReportDescriptor[] = {
   REPORT_SIZE(1),      0x08, //     REPORT_SIZE (8)
   REPORT_COUNT(1),     0x03, //     REPORT_COUNT (3)
   HIDINPUT(1),         0x06, //     INPUT (Data, Variable, Relative) ;3 bytes (X,Y,Wheel)
+#endif
+#ifdef HM_HID_HIRES_WHEEL
+  // ------------------------------------------------- Wheel with resolution multiplier
+  COLLECTION(1),       0x02, //     COLLECTION (Logical)
+  USAGE(1),            0x48, //       USAGE (Resolution Multiplier)
+  LOGICAL_MINIMUM(1),  0x00, //       LOGICAL_MINIMUM (0)
+  LOGICAL_MAXIMUM(1),  0x01, //       LOGICAL_MAXIMUM (1)
+  PHYSICAL_MINIMUM(1), 0x01, //       PHYSICAL_MINIMUM (1)
+  PHYSICAL_MAXIMUM(1), WHEEL_HIRES_MULTIPLIER, // PHYSICAL_MAXIMUM (8)
+  REPORT_SIZE(1),      0x02, //       REPORT_SIZE (2)
+  REPORT_COUNT(1),     0x01, //       REPORT_COUNT (1)
+  FEATURE(1),          0x02, //       FEATURE (Data, Variable, Absolute) ;2 bits wheel multiplier
+  PHYSICAL_MINIMUM(1), 0x00, //       PHYSICAL_MINIMUM (0)
+  PHYSICAL_MAXIMUM(1), 0x00, //       PHYSICAL_MAXIMUM (0)
+  USAGE(1),            0x38, //       USAGE (Wheel)
+  LOGICAL_MINIMUM(1),  0x81, //       LOGICAL_MINIMUM (-127)
+  LOGICAL_MAXIMUM(1),  0x7f, //       LOGICAL_MAXIMUM (127)
+  REPORT_SIZE(1),      0x08, //       REPORT_SIZE (8)
+  REPORT_COUNT(1),     0x01, //       REPORT_COUNT (1)
+  HIDINPUT(1),         0x06, //       INPUT (Data, Variable, Relative) ;1 byte (Wheel)
+  END_COLLECTION(0),         //     END_COLLECTION
+  // ------------------------------------------------- Horizontal wheel with resolution multiplier
+  COLLECTION(1),       0x02, //     COLLECTION (Logical)
+  USAGE(1),            0x48, //       USAGE (Resolution Multiplier)
+  LOGICAL_MINIMUM(1),  0x00, //       LOGICAL_MINIMUM (0)
+  LOGICAL_MAXIMUM(1),  0x01, //       LOGICAL_MAXIMUM (1)
+  PHYSICAL_MINIMUM(1), 0x01, //       PHYSICAL_MINIMUM (1)
+  PHYSICAL_MAXIMUM(1), WHEEL_HIRES_MULTIPLIER, // PHYSICAL_MAXIMUM (8)
+  REPORT_SIZE(1),      0x02, //       REPORT_SIZE (2)
+  REPORT_COUNT(1),     0x01, //       REPORT_COUNT (1)
+  FEATURE(1),          0x02, //       FEATURE (Data, Variable, Absolute) ;2 bits pan multiplier
+  PHYSICAL_MINIMUM(1), 0x00, //       PHYSICAL_MINIMUM (0)
+  PHYSICAL_MAXIMUM(1), 0x00, //       PHYSICAL_MAXIMUM (0)
+  USAGE_PAGE(1),       0x0c, //       USAGE PAGE (Consumer Devices)
+  USAGE(2),      0x38, 0x02, //       USAGE (AC Pan)
+  LOGICAL_MINIMUM(1),  0x81, //       LOGICAL_MINIMUM (-127)
+  LOGICAL_MAXIMUM(1),  0x7f, //       LOGICAL_MAXIMUM (127)
+  REPORT_SIZE(1),      0x08, //       REPORT_SIZE (8)
+  REPORT_COUNT(1),     0x01, //       REPORT_COUNT (1)
+  HIDINPUT(1),         0x06, //       INPUT (Data, Var, Rel)
+  END_COLLECTION(0),         //     END_COLLECTION
+  // ------------------------------------------------- Feature padding
+  REPORT_SIZE(1),      0x04, //     REPORT_SIZE (4)
+  REPORT_COUNT(1),     0x01, //     REPORT_COUNT (1)
+  FEATURE(1),          0x03, //     FEATURE (Constant, Variable, Absolute) ;4 bit padding
+#else
+#ifdef HM_HID_16BIT
+  // ------------------------------------------------- Wheel
+  USAGE(1),            0x38, //     USAGE (Wheel)
+  LOGICAL_MINIMUM(1),  0x81, //     LOGICAL_MINIMUM (-127)
+  LOGICAL_MAXIMUM(1),  0x7f, //     LOGICAL_MAXIMUM (127)
+  REPORT_SIZE(1),      0x08, //     REPORT_SIZE (8)
+  REPORT_COUNT(1),     0x01, //     REPORT_COUNT (1)
+  HIDINPUT(1),         0x06, //     INPUT (Data, Variable, Relative) ;1 byte (Wheel)
+#endif
   // ------------------------------------------------- Horizontal wheel
   USAGE_PAGE(1),       0x0c, //     USAGE PAGE (Consumer Devices)
   USAGE(2),      0x38, 0x02, //     USAGE (AC Pan)
@@ -59,7 +139,56 @@ static const uint8_t _hidReportDescriptor[] = {
   REPORT_SIZE(1),      0x08, //     REPORT_SIZE (8)
   REPORT_COUNT(1),     0x01, //     REPORT_COUNT (1)
   HIDINPUT(1),         0x06, //     INPUT (Data, Var, Rel)
+#endif
   END_COLLECTION(0),         //   END_COLLECTION
+#ifdef HM_HID_ABSOLUTE
+  END_COLLECTION(0),         // END_COLLECTION
+  // ================================================= Absolute pointer
+  USAGE_PAGE(1),       0x01, // USAGE_PAGE (Generic Desktop)
+  USAGE(1),            0x02, // USAGE (Mouse)
+  COLLECTION(1),       0x01, // COLLECTION (Application)
+  REPORT_ID(1),        0x02, //   REPORT_ID (2)
+  USAGE(1),            0x01, //   USAGE (Pointer)
+  COLLECTION(1),       0x00, //   COLLECTION (Physical)
+  // ------------------------------------------------- Buttons (Left, Right, Middle, Back, Forward)
+  USAGE_PAGE(1),       0x09, //     USAGE_PAGE (Button)
+  USAGE_MINIMUM(1),    0x01, //     USAGE_MINIMUM (Button 1)
+  USAGE_MAXIMUM(1),    0x05, //     USAGE_MAXIMUM (Button 5)
+  LOGICAL_MINIMUM(1),  0x00, //     LOGICAL_MINIMUM (0)
+  LOGICAL_MAXIMUM(1),  0x01, //     LOGICAL_MAXIMUM (1)
+  REPORT_SIZE(1),      0x01, //     REPORT_SIZE (1)
+  REPORT_COUNT(1),     0x05, //     REPORT_COUNT (5)
+  HIDINPUT(1),         0x02, //     INPUT (Data, Variable, Absolute) ;5 button bits
+  // ------------------------------------------------- Padding
+  REPORT_SIZE(1),      0x03, //     REPORT_SIZE (3)
+  REPORT_COUNT(1),     0x01, //     REPORT_COUNT (1)
+  HIDINPUT(1),         0x03, //     INPUT (Constant, Variable, Absolute) ;3 bit padding
+  // ------------------------------------------------- X/Y position (absolute, whole screen)
+  USAGE_PAGE(1),       0x01, //     USAGE_PAGE (Generic Desktop)
+  USAGE(1),            0x30, //     USAGE (X)
+  USAGE(1),            0x31, //     USAGE (Y)
+  LOGICAL_MINIMUM(1),  0x00, //     LOGICAL_MINIMUM (0)
+  LOGICAL_MAXIMUM(2),  0xff, 0x7f, // LOGICAL_MAXIMUM (32767)
+  REPORT_SIZE(1),      0x10, //     REPORT_SIZE (16)
+  REPORT_COUNT(1),     0x02, //     REPORT_COUNT (2)
+  HIDINPUT(1),         0x02, //     INPUT (Data, Variable, Absolute) ;4 bytes (X,Y)
+  // ------------------------------------------------- Wheel
+  USAGE(1),            0x38, //     USAGE (Wheel)
+  LOGICAL_MINIMUM(1),  0x81, //     LOGICAL_MINIMUM (-127)
+  LOGICAL_MAXIMUM(1),  0x7f, //     LOGICAL_MAXIMUM (127)
+  REPORT_SIZE(1),      0x08, //     REPORT_SIZE (8)
+  REPORT_COUNT(1),     0x01, //     REPORT_COUNT (1)
+  HIDINPUT(1),         0x06, //     INPUT (Data, Variable, Relative) ;1 byte (Wheel)
+  // ------------------------------------------------- Horizontal wheel
+  USAGE_PAGE(1),       0x0c, //     USAGE PAGE (Consumer Devices)
+  USAGE(2),      0x38, 0x02, //     USAGE (AC Pan)
+  LOGICAL_MINIMUM(1),  0x81, //     LOGICAL_MINIMUM (-127)
+  LOGICAL_MAXIMUM(1),  0x7f, //     LOGICAL_MAXIMUM (127)
+  REPORT_SIZE(1),      0x08, //     REPORT_SIZE (8)
+  REPORT_COUNT(1),     0x01, //     REPORT_COUNT (1)
+  HIDINPUT(1),         0x06, //     INPUT (Data, Var, Rel)
+  END_COLLECTION(0),         //   END_COLLECTION
+#endif
   END_COLLECTION(0)          // END_COLLECTION
 };
 
@@ -70,9 +199,9 @@ BleMouse::BleMouse(std::string deviceName, std::string deviceManufacturer, uint8
   this->connectionStatus = new BleConnectionStatus();
 }
 
-void BleMouse::begin(void)
+void BleMouse::begin(BaseType_t core)
 {
-  xTaskCreate(this->taskServer, "server", 10000, (void *)this, 5, NULL);
+  xTaskCreatePinnedToCore(this->taskServer, "server", 10000, (void *)this, 5, NULL, core);
 }
 
 void BleMouse::end(void)
@@ -96,6 +225,9 @@ void BleMouse::click(uint8_t b)
 
 void BleMouse::move(signed char x, signed char y, signed char wheel, signed char hWheel)
 {
+#ifdef HM_HID_16BIT
+  move((int)x, (int)y, wheel, hWheel);
+#else
   if (this->isConnected())
   {
     uint8_t m[5];
@@ -107,8 +239,69 @@ void BleMouse::move(signed char x, signed char y, signed char wheel, signed char
     this->inputMouse->setValue(m, 5);
     this->inputMouse->notify();
   }
+#endif
+}
+
+#ifdef HM_HID_16BIT
+void BleMouse::move(int x, int y, signed char wheel, signed char hWheel)
+{
+  if (this->isConnected())
+  {
+    int16_t x16 = (x > 32767) ? 32767 : (x < -32767) ? -32767 : (int16_t)x;
+    int16_t y16 = (y > 32767) ? 32767 : (y < -32767) ? -32767 : (int16_t)y;
+    uint8_t m[7];
+    m[0] = _buttons;
+    m[1] = (uint8_t)(x16 & 0xff);
+    m[2] = (uint8_t)((uint16_t)x16 >> 8);
+    m[3] = (uint8_t)(y16 & 0xff);
+    m[4] = (uint8_t)((uint16_t)y16 >> 8);
+    m[5] = wheel;
+    m[6] = hWheel;
+    this->inputMouse->setValue(m, 7);
+    this->inputMouse->notify();
+  }
+}
+#endif
+
+void BleMouse::report(uint8_t b, int x, int y, signed char wheel, signed char hWheel)
+{
+  _buttons = b;
+#ifdef HM_HID_16BIT
+  move(x, y, wheel, hWheel);
+#else
+  signed char x8 = (x > 127) ? 127 : (x < -127) ? -127 : (signed char)x;
+  signed char y8 = (y > 127) ? 127 : (y < -127) ? -127 : (signed char)y;
+  move(x8, y8, wheel, hWheel);
+#endif
+}
+
+#ifdef HM_HID_ABSOLUTE
+void BleMouse::moveTo(int x, int y, signed char wheel, signed char hWheel)
+{
+  if (this->isConnected())
+  {
+    uint16_t x16 = (x > ABS_POSITION_MAX) ? ABS_POSITION_MAX : (x < 0) ? 0 : (uint16_t)x;
+    uint16_t y16 = (y > ABS_POSITION_MAX) ? ABS_POSITION_MAX : (y < 0) ? 0 : (uint16_t)y;
+    uint8_t m[7];
+    m[0] = _buttons;
+    m[1] = (uint8_t)(x16 & 0xff);
+    m[2] = (uint8_t)(x16 >> 8);
+    m[3] = (uint8_t)(y16 & 0xff);
+    m[4] = (uint8_t)(y16 >> 8);
+    m[5] = wheel;
+    m[6] = hWheel;
+    this->inputAbsolute->setValue(m, 7);
+    this->inputAbsolute->notify();
+  }
 }
 
+void BleMouse::reportAbsolute(uint8_t b, int x, int y, signed char wheel, signed char hWheel)
+{
+  _buttons = b;
+  moveTo(x, y, wheel, hWheel);
+}
+#endif
+
 void BleMouse::buttons(uint8_t b)
 {
   if (b != _buttons)
@@ -139,6 +332,52 @@ bool BleMouse::isConnected(void) {
   return this->connectionStatus->connected;
 }
 
+void BleMouse::requestConnParams(uint16_t minInterval, uint16_t maxInterval, uint16_t latency, uint16_t timeout)
+{
+  if (this->isConnected() && (pServer != nullptr))
+    pServer->updateConnParams(this->connectionStatus->remoteBda, minInterval, maxInterval, latency, timeout);
+}
+
+uint8_t BleMouse::getWheelMultiplier(void)
+{
+#ifdef HM_HID_HIRES_WHEEL
+  if ((this->featureWheel != nullptr) && (this->featureWheel->getLength() > 0) && (this->featureWheel->getData()[0] & 0x03))
+    return WHEEL_HIRES_MULTIPLIER;
+#endif
+  return 1;
+}
+
+uint8_t BleMouse::getPanMultiplier(void)
+{
+#ifdef HM_HID_HIRES_WHEEL
+  if ((this->featureWheel != nullptr) && (this->featureWheel->getLength() > 0) && (this->featureWheel->getData()[0] & 0x0c))
+    return WHEEL_HIRES_MULTIPLIER;
+#endif
+  return 1;
+}
+
+uint16_t BleMouse::getConnInterval(void) {
+  return this->connectionStatus->connInterval;
+}
+
+uint16_t BleMouse::getConnLatency(void) {
+  return this->connectionStatus->connLatency;
+}
+
+uint16_t BleMouse::getConnTimeout(void) {
+  return this->connectionStatus->connTimeout;
+}
+
+void BleMouse::gapHandler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param)
+{
+  if ((event == ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT) && (gapConnectionStatus != nullptr))
+  {
+    gapConnectionStatus->onConnParamsUpdate(param);
+    ESP_LOGD(LOG_TAG, "Connection parameters: interval %d, latency %d, timeout %d", param->update_conn_params.conn_int,
+             param->update_conn_params.latency, param->update_conn_params.timeout);
+  }
+}
+
 void BleMouse::setBatteryLevel(uint8_t level) {
   this->batteryLevel = level;
   if (hid != 0)
@@ -148,13 +387,23 @@ void BleMouse::setBatteryLevel(uint8_t level) {
 void BleMouse::taskServer(void* pvParameter) {
   BleMouse* bleMouseInstance = (BleMouse *) pvParameter; //static_cast<BleMouse *>(pvParameter);
   BLEDevice::init(bleMouseInstance->deviceName);
+  gapConnectionStatus = bleMouseInstance->connectionStatus;
+  BLEDevice::setCustomGapHandler(gapHandler);
  
   pServer = BLEDevice::createServer();
   pServer->setCallbacks(bleMouseInstance->connectionStatus);
 
   bleMouseInstance->hid = new BLEHIDDevice(pServer);
-  bleMouseInstance->inputMouse = bleMouseInstance->hid->inputReport(0); // <-- input REPORTID from report map
+  bleMouseInstance->inputMouse = bleMouseInstance->hid->inputReport(MOUSE_REPORT_ID); // <-- input REPORTID from report map
   bleMouseInstance->connectionStatus->inputMouse = bleMouseInstance->inputMouse;
+#ifdef HM_HID_ABSOLUTE
+  bleMouseInstance->inputAbsolute = bleMouseInstance->hid->inputReport(2);
+  bleMouseInstance->connectionStatus->inputAbsolute = bleMouseInstance->inputAbsolute;
+#endif
+#ifdef HM_HID_HIRES_WHEEL
+  bleMouseInstance->featureWheel = bleMouseInstance->hid->featureReport(MOUSE_REPORT_ID);
+  bleMouseInstance->connectionStatus->featureWheel = bleMouseInstance->featureWheel;
+#endif
 
   bleMouseInstance->hid->manufacturer()->setValue(bleMouseInstance->deviceManufacturer);
 
@@ -14,6 +14,13 @@
 #define MOUSE_BACK 8
 #define MOUSE_FORWARD 16
 #define MOUSE_ALL (MOUSE_LEFT | MOUSE_RIGHT | MOUSE_MIDDLE) # For compatibility with the Mouse library
+#define ABS_POSITION_MAX 32767  // logical maximum of the absolute pointer report, mapped to the whole screen
+#define WHEEL_HIRES_MULTIPLIER 8  // wheel counts per detent if the host enables the resolution multiplier
+#ifdef HM_HID_ABSOLUTE
+#define MOUSE_REPORT_ID 1
+#else
+#define MOUSE_REPORT_ID 0
+#endif
 
 class BleMouse {
 private:
@@ -21,22 +28,39 @@ private:
   BleConnectionStatus* connectionStatus;
   BLEHIDDevice* hid;
   BLECharacteristic* inputMouse;
+  BLECharacteristic* inputAbsolute = nullptr;
+  BLECharacteristic* featureWheel = nullptr;  // resolution multipliers set by the host
   static BLEAdvertising *pAdvertising;
   static BLEServer *pServer;
   static void taskServer(void* pvParameter);
+  static void gapHandler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param);
   void buttons(uint8_t b);
   void rawAction(uint8_t msg[], char msgSize);
 public:
   BleMouse(std::string deviceName = "ESP32 Bluetooth Mouse", std::string deviceManufacturer = "Espressif", uint8_t batteryLevel = 100);
-  void begin(void);
+  void begin(BaseType_t core = tskNO_AFFINITY);  // core of the BLE server task
   void end(void);
   void connectNewDevice(void);
   void click(uint8_t b = MOUSE_LEFT);
   void move(signed char x, signed char y, signed char wheel = 0, signed char hWheel = 0);
+#ifdef HM_HID_16BIT
+  void move(int x, int y, signed char wheel = 0, signed char hWheel = 0);  // 16 bit X/Y, saturated to +-32767
+#endif
+  void report(uint8_t b, int x, int y, signed char wheel = 0, signed char hWheel = 0); // one report with button state, X/Y saturated
+#ifdef HM_HID_ABSOLUTE
+  void moveTo(int x, int y, signed char wheel = 0, signed char hWheel = 0);  // absolute position 0..ABS_POSITION_MAX
+  void reportAbsolute(uint8_t b, int x, int y, signed char wheel = 0, signed char hWheel = 0);
+#endif
   void press(uint8_t b = MOUSE_LEFT);   // press LEFT by default
   void release(uint8_t b = MOUSE_LEFT); // release LEFT by default
   bool isPressed(uint8_t b = MOUSE_LEFT); // check LEFT by default
   bool isConnected(void);
+  void requestConnParams(uint16_t minInterval, uint16_t maxInterval, uint16_t latency, uint16_t timeout); // intervals [1.25 ms], timeout [10 ms]
+  uint16_t getConnInterval(void);   // negotiated interval [1.25 ms], 0 if not connected
+  uint16_t getConnLatency(void);    // negotiated slave latency [connection events]
+  uint16_t getConnTimeout(void);    // negotiated supervision timeout [10 ms]
+  uint8_t getWheelMultiplier(void); // wheel counts per detent set by the host, 1 without HM_HID_HIRES_WHEEL
+  uint8_t getPanMultiplier(void);   // horizontal wheel counts per detent set by the host
   void setBatteryLevel(uint8_t level);
   uint8_t batteryLevel;
   std::string deviceManufacturer;
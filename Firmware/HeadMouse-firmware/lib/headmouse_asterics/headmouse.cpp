@@ -2,6 +2,7 @@
 #include <Wire.h>
 #include <utility/imumaths.h>
 #include <Preferences.h>
+#include "esp_timer.h"
 #include "headmouse.hpp"
 #include "BleMouse.h"
 #include "Adafruit_Sensor.h"
@@ -13,30 +14,144 @@ namespace _headmouse{
     Preferences nonVolatileMemory;
     Adafruit_BNO055 bno = Adafruit_BNO055(BNO055_SENSOR_ID, BNO055_I2C_ADDRESS, &Wire);
     BleMouse bleMouse(DEVICE_NAME, DEVICE_MANUFACTURER, BAT_LEVEL_DUMMY);
-    volatile bool _measurement_available = 0;
+    volatile uint32_t _program_cycle_ticks = 0;
+    volatile uint32_t _sample_ready_count = 0;      // BNO055 data ready interrupts
+    volatile uint32_t _sample_ready_us = 0;         // Time of the last data ready interrupt (lower 32 bit)
+    volatile uint32_t _timer_sample_count = 0;      // Data ready interrupts seen by the program cycle timer
+    volatile uint32_t _timer_idle_ticks = 0;        // Program cycle timer ticks without data ready
+    volatile uint32_t _timer_ticks = 0;             // Program cycle timer ticks, clock of the housekeeping jobs
+    volatile bool _tasks_started = false;
+    TaskSignal _sensor_signal;                      // Program cycle tick -> sensor task
+    TaskSignal _motion_signal;                      // New IMU sample -> motion task
+    TaskSignal _hid_signal;                         // New mouse movement or button event -> HID task
+    TaskSignal _housekeeping_signal;                // Program cycle tick -> housekeeping task
 }
 
 namespace isr{
-    ESP32Timer ProgramCycleTimer(2);
+    TickTimer SystemTick(0);
 }
 using namespace isr;
 using namespace _headmouse;
 using namespace preferences;
 
+static constexpr double QUAT_RAW_SCALE = 1.0 / (1 << 14);  // BNO055 quaternion unit per LSB
+
+/************************************************************
+ * @brief Count a program cycle tick and wake the sensor task if
+ *        the task pipeline is running. Called by ISRs only.
+ *************************************************************/
+static inline void IRAM_ATTR _programCycleTick(){
+    _program_cycle_ticks++;     // Only written by ISRs, read as a single 32-bit word by the main loop
+    if(_tasks_started) _sensor_signal.giveFromIsr();
+}
+
 /************************************************************
  * @brief Timer callback function for program cycle timer.
  *
  * This function is called by the timer interrupt indicate a new
- * program/IMU measurement cycle
+ * program/IMU measurement cycle. With the task pipeline running it
+ * also wakes the housekeeping task on every tick.
  *
- * @param timerNo The timer number (unused).
+ * @param channel The tick timer channel (unused).
  * @return Always returns true.
  *************************************************************/
-bool IRAM_ATTR HeadMouse::_callbackTimerProgramCycle(void * timerNo){
-    _measurement_available = true;
+bool IRAM_ATTR HeadMouse::_callbackTimerProgramCycle(void * channel){
+    (void)channel;
+    _timer_ticks++;
+    if(_tasks_started) _housekeeping_signal.giveFromIsr();
+#ifdef HM_SAMPLING_BNO055_INT
+    /* Program cycles are started by the data ready interrupt, the timer only takes over if it stays silent */
+    if(_sample_ready_count != _timer_sample_count){
+        _timer_sample_count = _sample_ready_count;
+        _timer_idle_ticks = 0;
+        return true;
+    }
+    if(_timer_idle_ticks < SAMPLE_INT_TIMEOUT_TICKS){
+        _timer_idle_ticks++;
+        return true;
+    }
+#endif
+    _programCycleTick();
     return true;
 }
 
+/************************************************************
+ * @brief Interrupt callback of the BNO055 data ready signal.
+ *
+ * Timestamps every new fusion sample. With HM_SAMPLING_BNO055_INT
+ * each sample starts a program cycle.
+ *************************************************************/
+void IRAM_ATTR HeadMouse::_callbackSampleReady(){
+    _sample_ready_us = (uint32_t)esp_timer_get_time();
+    _sample_ready_count++;
+#ifdef HM_SAMPLING_BNO055_INT
+    _programCycleTick();
+#endif
+}
+
+/************************************************************
+ * @brief Callback of the buttons for every queued button event.
+ *
+ * Wakes the HID task, so button events are sent without waiting
+ * for the next program cycle.
+ *************************************************************/
+void IRAM_ATTR HeadMouse::_callbackBtnEvent(){
+    if(_tasks_started) _hid_signal.giveFromIsr();
+}
+
+/************************************************************
+ * @brief Convert head rotation to mouse counts.
+ *
+ * The fraction of a count that is left over is carried to the
+ * next cycle, so slow head movements are not truncated away and
+ * the cursor travel matches the head rotation in both directions.
+ *
+ * @param change Head rotation [RAD]*2^MOTION_Q_SHIFT.
+ * @param gain Counts per RAD*2^MOTION_Q_SHIFT (sensitivity * 
+ *             MOTION_GAIN_PER_SENSITIVITY).
+ * @param residual In/out: fraction of a count of this axis 
+ *                 [0, 2^MOTION_Q_SHIFT).
+ * @return Mouse counts.
+ *************************************************************/
+static inline int32_t _motionToCounts(int32_t change, int32_t gain, int32_t* residual){
+    int32_t product = change * gain + *residual;
+    *residual = product & (MOTION_Q_ONE - 1);
+    return product >> MOTION_Q_SHIFT;
+}
+
+static inline int32_t _clampMotion(int32_t change){
+    if(change > MOTION_DELTA_MAX) return MOTION_DELTA_MAX;
+    if(change < -MOTION_DELTA_MAX) return -MOTION_DELTA_MAX;
+    return change;
+}
+
+static constexpr int VELOCITY_SCALE_SHIFT = 8;      // Fractional bits of the samples per second
+
+/************************************************************
+ * @brief Apply the pointer acceleration curve to one axis.
+ *
+ * The gain is taken from the curve at the head angular velocity, 
+ * so the transfer function does not depend on the sample rate. 
+ * Velocities within the deadband are ignored.
+ *
+ * @param change Head rotation since last sample [RAD]*2^MOTION_Q_SHIFT.
+ * @param velocity_scale Samples per second [1/s]*2^VELOCITY_SCALE_SHIFT.
+ * @param curve Active pointer acceleration curve.
+ * @param deadband Largest ignored velocity [RAD/s]*2^MOTION_V_SHIFT,
+ *                 the jitter offset for the pointer.
+ * @param residual In/out: fraction of a count of this axis.
+ * @return Mouse counts.
+ *************************************************************/
+static inline int32_t _motionCurve(int32_t change, uint32_t velocity_scale, const MotionCurveTable& curve, int32_t deadband, 
+                                   int32_t* residual){
+    int32_t magnitude = (change >= 0) ? change : -change;
+    int64_t velocity = ((int64_t)magnitude * velocity_scale) >> (MOTION_Q_SHIFT + VELOCITY_SCALE_SHIFT - MOTION_V_SHIFT);
+
+    if(velocity <= deadband) return 0;
+    if(velocity > MOTION_V_MAX) velocity = MOTION_V_MAX;
+    return _motionToCounts(change, curve.gain((int32_t)velocity), residual);
+}
+
 /* PRIVATE METHODS **************************************************/
 
 /************************************************************
@@ -120,6 +235,31 @@ void HeadMouse::_initPreferences(HmPreferences preferences){
         }
             
     }
+
+    for(uint32_t i=0; i<SENSITIVITY_STEP_COUNT; i++){
+        MotionCurve curve;
+        if(nonVolatileMemory.isKey(STORE_CURVE[i]) && (nonVolatileMemory.getBytes(STORE_CURVE[i], &curve, sizeof(curve)) == sizeof(curve))
+           && MotionCurveTable::isValid(curve)){
+            _preferences.curves[i] = curve;
+            log_message(LOG_INFO, "...CURVE%d preferences loaded from memory: %d points", i, curve.point_count);
+        } else{
+            _preferences.curves[i] = preferences.curves[i];
+            nonVolatileMemory.putBytes(STORE_CURVE[i], &_preferences.curves[i], sizeof(MotionCurve));
+            log_message(LOG_INFO, "...CURVE%d default preferences set: %d points", i, _preferences.curves[i].point_count);
+        }
+    }
+
+    GestureConfig gestures;
+    if(nonVolatileMemory.isKey(STORE_GESTURES) && (nonVolatileMemory.getBytes(STORE_GESTURES, &gestures, sizeof(gestures)) == sizeof(gestures))
+       && GestureFsm::isValid(gestures)){
+        _preferences.gestures = gestures;
+        log_message(LOG_INFO, "...GESTURE preferences loaded from memory");
+    } else{
+        _preferences.gestures = GestureFsm::isMapped(preferences.gestures) ? preferences.gestures : GestureFsm::defaultConfig(_preferences.btn_actions);
+        nonVolatileMemory.putBytes(STORE_GESTURES, &_preferences.gestures, sizeof(GestureConfig));
+        log_message(LOG_INFO, "...GESTURE default preferences set");
+    }
+    _gestures.setConfig(_preferences.gestures);
    }
 
 
@@ -240,408 +380,1287 @@ void HeadMouse::_devStatusInterpreter(){
     }      
 }
 
-/* PUBLIC METHODS */
-/************************************************************
- * @brief Check if new BNO055 measurement cycle has finished
- * 
- * @return TRUE if new data is available, FALSE otherwise.
- *************************************************************/
-bool HeadMouse::isMeasurementAvailable(){
-    if(_measurement_available){
-        return true;
-        _measurement_available = false;
-    }
-    else return false;
-}
-
 /************************************************************
- * @brief Initialize HeadMouse hardware components.
+ * @brief Calculate head rotation since last cycle from Euler
+ *        angles.
  *
- * This function initializes the various hardware components of
- * the HeadMouse, including pins, BLE communication, and the IMU.
- * 
- * @param preferences Struct containing device preferences.
- * @return ERR_xxx if something went wrong, OK otherwise.
+ * Converts the orientation quaternion to Euler angles and takes
+ * the difference to the angles of the previous cycle. Wraparound
+ * at +-PI and zero crossings are guarded separately.
+ *
+ * @param quat Current orientation quaternion.
+ * @param change_x Output: horizontal rotation [RAD]*2^MOTION_Q_SHIFT.
+ * @param change_y Output: vertical rotation [RAD]*2^MOTION_Q_SHIFT.
  *************************************************************/
-err HeadMouse::init(HmPreferences preferences){
-    err error = ERR_GENERIC;
-
-    /* Setup HM preferences */
-    _preferences.mode = preferences.mode;    // Testing only 
-    _preferences.sensititvity = preferences.sensititvity;
-    _preferences.btn_actions[0] = preferences.btn_actions[0];
-    _preferences.btn_actions[1] = preferences.btn_actions[1];
-    _preferences.btn_actions[2] = preferences.btn_actions[2];
-    _preferences.btn_actions[3] = preferences.btn_actions[3];
-    //_initPreferences(preferences);
-    log_message(LOG_INFO, "...Preferences initialized");
+void HeadMouse::_motionDeltaEuler(imu::Quaternion& quat, int32_t* change_x, int32_t* change_y){
+    static bool first_run = true;
+    static imu::Vector<3> euler;
+    imu::Vector<3> new_euler = quat.toEuler();
+    int32_t mouse_change_x = 0;
+    int32_t mouse_change_y = 0;
 
-    /* Init uC peripherals */
-    _initPins();
-    log_message(LOG_INFO, "...Pins initialized");
+    if(first_run){
+        first_run = false;
+        euler = new_euler;
+    }
 
-    if(ProgramCycleTimer.attachInterruptInterval(PROGRAM_CYCLE_INTERVAL_MS*1000, _callbackTimerProgramCycle))
-    {    
-        log_message(LOG_INFO, "...Program cycle timer initialized"); 
+    /* X-AXIS */
+    if(((new_euler.x() >= 3.14) && (euler.x() < -3.14)) || (new_euler.x() < -3.14) && (euler.x() >= 3.14)){         // Guard edge case
+        mouse_change_x = (int32_t)(MOTION_Q_ONE*(new_euler.x() + euler.x()));
+    }
+    else if(((new_euler.x() < -0) && (euler.x() >= 0)) || ((new_euler.x() > -0) && (euler.x() <= 0))){    // Guard edge case
+        mouse_change_x = (int32_t)(MOTION_Q_ONE*(new_euler.x() + euler.x()));
     }
     else{
-        log_message(LOG_INFO, "... Cannot init Program cycle timer, aborting..."); 
-        return ERR_GENERIC;
+        mouse_change_x = (int32_t)(MOTION_Q_ONE*(euler.x() - new_euler.x())); 
     }
 
-    /* Start ble task manager for bluetooth mouse communication */
-    bleMouse.begin();  
-    log_message(LOG_INFO, "...BLE server initialized"); 
-
-    /* Initialise IMU */
-    if(bno.begin()){
-        log_message(LOG_INFO, "...BNO055 initialized");
+    /* Y-AXIS */
+    if(((new_euler.z() >= 3.14) && (euler.z() < -3.14)) || (new_euler.z() < -3.14) && (euler.z() >= 3.14)){         // Guard edge case
+        mouse_change_y = (int32_t)(MOTION_Q_ONE*(new_euler.z() + euler.z()));
+    }
+    else if(((new_euler.z() < -0) && (euler.z() >= 0)) || ((new_euler.z() > -0) && (euler.z() <= 0))){    // Guard edge case
+        mouse_change_y = (int32_t)(MOTION_Q_ONE*(new_euler.z() + euler.z()));
     }
     else{
-        _status.is_error = true;
-        log_message(LOG_ERROR, "...Cannot connect to BNO055");
-        return ERR_CONNECTION_FAILED;
+        mouse_change_y = (int32_t)(MOTION_Q_ONE*(new_euler.z() - euler.z())); 
     }
 
-    return ERR_NONE;
-}
+    /* Update imu data buffer for later on comparison */
+    euler.x() = new_euler.x();
+    euler.z() = new_euler.z();
 
+    *change_x = _clampMotion(mouse_change_x);
+    *change_y = _clampMotion(mouse_change_y);
+}
 
 /************************************************************
- * @brief Update current device status.
+ * @brief Calculate head rotation since last cycle from the
+ *        relative quaternion.
  *
- * This function updates the current status of the device,
- * including battery status, IMU calibration, charging status,
- * and BLE connection.
+ * Computes the relative rotation q_prev^-1 * q_new in the sensor
+ * frame and uses the small-angle approximation (rotation vector
+ * = 2 * vector part). The body rates are converted to Euler angle
+ * rates through the current orientation, so the output matches 
+ * the Euler engine at any head tilt, without trigonometric 
+ * functions or wraparound guards:
+ *   yaw'  = (w_y*R32 + w_z*R33) / cos^2(pitch)
+ *   roll' = w_x - yaw'*R31
+ * with Rij being elements of the current rotation matrix.
  *
- * @return Device status struct.
+ * @param quat Current orientation quaternion.
+ * @param change_x Output: horizontal rotation [RAD]*2^MOTION_Q_SHIFT.
+ * @param change_y Output: vertical rotation [RAD]*2^MOTION_Q_SHIFT.
  *************************************************************/
-HmStatus HeadMouse::updateDevStatus(){
-    _status.is_calibrated = isCalibrated();
-    _status.is_charging = isCharging();
-    _status.is_connected = isConnected();
-    updateBatStatus();
-
-    log_message(LOG_DEBUG, "Status: \nisCharging: %d\nBatStatus: %d, \nisCalibrated: %d, \nisConnected: %d", 
-    _status.is_charging, _status.bat_status, _status.is_calibrated, _status.is_connected);
+void HeadMouse::_motionDeltaQuat(imu::Quaternion& quat, int32_t* change_x, int32_t* change_y){
+    static constexpr float COS2_MIN = 1.0f / 64;    // Limit gain near +-90 deg pitch, as the fixed-point engine
+    static bool first_run = true;
+    static float prev_w, prev_x, prev_y, prev_z;
+    float w = (float)quat.w();
+    float x = (float)quat.x();
+    float y = (float)quat.y();
+    float z = (float)quat.z();
 
-    _batStatusInterpreter();
-    _devStatusInterpreter();
+    if(first_run){
+        first_run = false;
+        prev_w = w; prev_x = x; prev_y = y; prev_z = z;
+    }
 
-    return _status;
+    /* Relative rotation q_rel = conj(q_prev) * q_new */
+    float rel_w = prev_w*w + prev_x*x + prev_y*y + prev_z*z;
+    float rel_x = prev_w*x - prev_x*w - prev_y*z + prev_z*y;
+    float rel_y = prev_w*y + prev_x*z - prev_y*w - prev_z*x;
+    float rel_z = prev_w*z - prev_x*y + prev_y*x - prev_z*w;
+    prev_w = w; prev_x = x; prev_y = y; prev_z = z;
+
+    /* Body rates: rotation vector = 2 * vector part, take shortest path, q and -q describe the same orientation */
+    float scale = (rel_w < 0) ? -2.0f : 2.0f;
+    float omega_x = scale*rel_x;
+    float omega_y = scale*rel_y;
+    float omega_z = scale*rel_z;
+
+    /* Rotation matrix elements of current orientation */
+    float r31 = 2.0f*(x*z - w*y);               /* -sin(pitch) */
+    float r32 = 2.0f*(y*z + w*x);               /* cos(pitch)*sin(roll) */
+    float r33 = w*w - x*x - y*y + z*z;          /* cos(pitch)*cos(roll) */
+    float cos2 = 1.0f - r31*r31;
+    if(cos2 < COS2_MIN) cos2 = COS2_MIN;
+
+    /* Euler angle rates */
+    float yaw = (omega_y*r32 + omega_z*r33) / cos2;
+    float roll = omega_x - yaw*r31;
+
+    /* Same sign convention as Euler engine: X = -yaw, Y = +roll */
+    *change_x = _clampMotion((int32_t)(-yaw*MOTION_Q_ONE));
+    *change_y = _clampMotion((int32_t)(roll*MOTION_Q_ONE));
 }
 
 /************************************************************
- * @brief Update IMU data and translate it into mouse movements.
+ * @brief Read the raw orientation quaternion of the BNO055.
  *
- * This function updates the IMU data and translates the head
- * movements into mouse cursor movements.
+ * Reads the quaternion data registers directly over I2C, which
+ * avoids the floating point scaling of Adafruit_BNO055::getQuat().
  *
- * @return ERR_xxx if something went wrong, OK otherwise.
+ * @param quat Output: w, x, y, z (1 LSB = 2^-14).
+ * @return TRUE if the registers have been read, FALSE otherwise.
  *************************************************************/
-err HeadMouse::updateMovements(){
-    static bool first_run = true;
-    int64_t mouse_change_x = 0;
-    int64_t mouse_change_y = 0;
-    int mouse_move_x = 0;
-    int mouse_move_y = 0;
-    static sensors_event_t imu_data;
-    sensors_event_t new_imu_data;
-    int32_t sensitivity_level = 0;
-    imu::Quaternion quat;
-    static imu::Vector<3> euler;
-    imu::Vector<3> new_euler;
-    
-    /* Get a new sensor event */
-    quat = bno.getQuat();
-    new_euler = quat.toEuler();
-    
-    //bno.getEvent(&new_imu_data);
-    if(first_run){
-        first_run = false;
-        euler = new_euler;
+bool HeadMouse::_readRawQuat(int16_t* quat){
+    uint8_t buffer[8];
 
-        /*
-        _imu_data.orientation.x = new_imu_data.orientation.x;
-        _imu_data.orientation.y = new_imu_data.orientation.y;
-        _imu_data.orientation.z = new_imu_data.orientation.z;
-        */
-    }
-    //log_message(LOG_DEBUG_IMU, "new IMU orientation data: X: %.2f, Y: %.2f, Z: %.2f", euler.x(), euler.y(), euler.z());
-
-
-    /* Determine currently active sensitivity level */
-    switch(_preferences.sensititvity){
-        case PREF_SENSITIVITY[0]: 
-            sensitivity_level = 0;
-        break;
-            case PREF_SENSITIVITY[1]: 
-            sensitivity_level = 1;
-        break;
-            case PREF_SENSITIVITY[2]: 
-            sensitivity_level = 2;
-        break;
-            case PREF_SENSITIVITY[3]: 
-            sensitivity_level = 3;
-        break;
-            case PREF_SENSITIVITY[4]: 
-            sensitivity_level = 4;
-        break;
-    }
-
-    /* X-AXIS DATA PROCESSING *******************/
-    /* Process Euler Angle data */
-    if(((new_euler.x() >= 3.14) && (euler.x() < -3.14)) || (new_euler.x() < -3.14) && (euler.x() >= 3.14)){         // Guard edge case
-        mouse_change_x = (int64_t)(SCALING_FACTOR*(new_euler.x() + euler.x()));
-        log_message(LOG_DEBUG_IMU, "mouse change x: %d", mouse_change_x);
-    }
-    else if(((new_euler.x() < -0) && (euler.x() >= 0)) || ((new_euler.x() > -0) && (euler.x() <= 0))){    // Guard edge case
-        mouse_change_x = (int64_t)(SCALING_FACTOR*(new_euler.x() + euler.x()));
-        log_message(LOG_DEBUG_IMU, "mouse change x: %d", mouse_change_x);
-    }
-    else{
-        mouse_change_x = (int64_t)(SCALING_FACTOR*(euler.x() - new_euler.x())); 
-        log_message(LOG_DEBUG_IMU, "mouse change x: %d", mouse_change_x);
-    }
+    Wire.beginTransmission(BNO055_I2C_ADDRESS);
+    Wire.write(BNO055_QUAT_DATA_REG);
+    if(Wire.endTransmission() != 0) return false;
+    if(Wire.requestFrom(BNO055_I2C_ADDRESS, (uint8_t)sizeof(buffer)) != sizeof(buffer)) return false;
 
-    /* Add jitter-offset to stabalize mouse when head is not moving */
-    if((mouse_change_x >= -JITTER_OFFSET) && (mouse_change_x <= JITTER_OFFSET)){
-        mouse_move_x = 0;  
-    }
-    /* Enter slow-motion mode if mouse is moving slowly to improve positioning accuracy */
-    else if((mouse_change_x >= -SLOW_MOTION_OFFSET) && (mouse_change_x <= SLOW_MOTION_OFFSET)){
-        for(int i=0; i<SENSITIVITY_STEP_COUNT; i++){
-            if((mouse_change_x > SLOWMO_ANGLE_DEFLECTION[i]) && (mouse_change_x <= SLOWMO_ANGLE_DEFLECTION[i+1])){
-                mouse_move_x = (int)((mouse_change_x * SLOWMO_SENSITIVITY[i][sensitivity_level]) / 20000);
-                break;
-            }
-            else if((mouse_change_x > -SLOWMO_ANGLE_DEFLECTION[i+1]) && (mouse_change_x <= -SLOWMO_ANGLE_DEFLECTION[i])){
-                mouse_move_x = (int)((mouse_change_x * SLOWMO_SENSITIVITY[i][sensitivity_level]) / 20000);
-                break;
-            }
-        }
+    for(int i=0; i<8; i++){
+        buffer[i] = (uint8_t)Wire.read();
     }
-    /* Normal operation: adjust mouse movement to chosen sensitivity level */
-    else{   
-        mouse_move_x = (int)((mouse_change_x * _preferences.sensititvity) / 20000);
+    for(int i=0; i<4; i++){
+        quat[i] = (int16_t)(((uint16_t)buffer[2*i+1] << 8) | buffer[2*i]);
     }
-    log_message(LOG_DEBUG_IMU, "move x: %d", mouse_move_x);
-    //log_message(LOG_DEBUG_IMU, "sensitivity: %d", _preferences.sensititvity);
+    return true;
+}
 
-    /* Y-AXIS DATA PROCESSING *******************/
-    /* Process Euler Angle data */
-    if(((new_euler.z() >= 3.14) && (euler.z() < -3.14)) || (new_euler.z() < -3.14) && (euler.z() >= 3.14)){         // Guard edge case
-        mouse_change_y = (int64_t)(SCALING_FACTOR*(new_euler.z() + euler.z()));
-        log_message(LOG_DEBUG_IMU, "mouse change y: %d", mouse_change_y);
+/************************************************************
+ * @brief Write a BNO055 register.
+ *
+ * @param reg Register address (of the active register page).
+ * @param value Register value.
+ * @return TRUE on success, FALSE if the I2C transfer failed.
+ *************************************************************/
+bool HeadMouse::_writeBnoRegister(uint8_t reg, uint8_t value){
+    Wire.beginTransmission(BNO055_I2C_ADDRESS);
+    Wire.write(reg);
+    Wire.write(value);
+    return (Wire.endTransmission() == 0);
+}
+
+/************************************************************
+ * @brief Enable the BNO055 data ready interrupt on PIN_BNO55_INT.
+ *
+ * The interrupt configuration is located on register page 1 and
+ * can only be changed in config mode.
+ *
+ * @return TRUE on success, FALSE if the sensor did not accept the
+ *         configuration.
+ *************************************************************/
+bool HeadMouse::_initSampleInterrupt(){
+    bool is_ok = true;
+
+    bno.setMode(OPERATION_MODE_CONFIG);
+    is_ok = is_ok && _writeBnoRegister(BNO055_PAGE_ID_REG, 1);
+    is_ok = is_ok && _writeBnoRegister(BNO055_INT_MSK_REG, BNO055_INT_ACC_BSX_DRDY);
+    is_ok = is_ok && _writeBnoRegister(BNO055_INT_EN_REG, BNO055_INT_ACC_BSX_DRDY);
+    _writeBnoRegister(BNO055_PAGE_ID_REG, 0);
+    bno.setMode(OPERATION_MODE_NDOF);
+    if(!is_ok) return false;
+
+    pinMode(PIN_BNO55_INT, INPUT);
+    attachInterrupt(digitalPinToInterrupt(PIN_BNO55_INT), _callbackSampleReady, RISING);
+    _writeBnoRegister(BNO055_SYS_TRIGGER_REG, BNO055_RST_INT);
+    return true;
+}
+
+/************************************************************
+ * @brief Add the latency of a button event sent as HID report
+ *        to the button statistics.
+ *
+ * @param timestamp_us Time of the button edge or gesture timeout
+ *                     causing the report [us].
+ *************************************************************/
+void HeadMouse::_updateButtonStats(int64_t timestamp_us){
+    int64_t latency_us = esp_timer_get_time() - timestamp_us;
+
+    if(latency_us < 0) return;
+    _cycle_stats.button.reports++;
+    _cycle_stats.button.latency_sum_us += (uint64_t)latency_us;
+    if(latency_us > _cycle_stats.button.latency_max_us) _cycle_stats.button.latency_max_us = (uint32_t)latency_us;
+}
+
+/************************************************************
+ * @brief Run the button action mapped to a recognised gesture.
+ *
+ * Long presses of left/right hold the mouse button until the
+ * push ends, all other actions run at the start of the gesture.
+ *
+ * @param gesture Recognised gesture.
+ *************************************************************/
+void HeadMouse::_runGestureAction(const GestureOutput& gesture){
+    int i = gesture.button;
+    btnAction action = (btnAction)_preferences.gestures.actions[i][gesture.gesture];
+    bool is_long = (gesture.gesture == GESTURE_LONG_PRESS);
+
+    if((action == RIGHT) || (action == LEFT)){
+        if(is_long && gesture.is_start){        /* PRESS */
+            _hid_output.press(action, gesture.timestamp_us);
+            log_message(LOG_INFO, "Button %d start press ",  i);
+        }
+        else if(is_long){                       /* RELEASE */
+            _hid_output.release(action, gesture.timestamp_us);
+            log_message(LOG_INFO, "Button %d stop press ",  i);
+        }
+        else{                                   /* CLICK */
+            _hid_output.click(action, gesture.timestamp_us);
+            log_message(LOG_INFO, "Button %d gesture %d ",  i, gesture.gesture);
+        }
     }
-    else if(((new_euler.z() < -0) && (euler.z() >= 0)) || ((new_euler.z() > -0) && (euler.z() <= 0))){    // Guard edge case
-        mouse_change_y = (int64_t)(SCALING_FACTOR*(new_euler.z() + euler.z()));
-        log_message(LOG_DEBUG_IMU, "mouse change y: %d", mouse_change_y);
+    else if(action == SCROLL){
+        if(is_long) setScrolling(gesture.is_start);     /* Scroll while held */
+        else if(gesture.is_start) setScrolling(!isScrolling());
     }
-    else{
-        mouse_change_y = (int64_t)(SCALING_FACTOR*(new_euler.z() - euler.z())); 
-        log_message(LOG_DEBUG_IMU, "mouse change y: %d", mouse_change_y);
+    else if(!gesture.is_start){
+        return;
     }
+    else if(action == SENSITIVITY){
+        if(_preferences.sensititvity == SENSITIVITY_MAX){
+            _preferences.sensititvity = SENSITIVITY_MIN;
+        }
+        else{ _preferences.sensititvity += SENSITIVITY_STEP;}
 
-    /* Add jitter-offset to stabalize mouse when head is not moving */
-    if((mouse_change_y >= -JITTER_OFFSET) && (mouse_change_y <= JITTER_OFFSET)){
-        mouse_move_y = 0;  
+        setSensitivity(_preferences.sensititvity);
     }
-    /* Enter slow-motion mode if mouse is moving slowly to improve positioning accuracy */
-    else if((mouse_change_y >= -SLOW_MOTION_OFFSET) && (mouse_change_y <= SLOW_MOTION_OFFSET)){
-        for(int i=0; i<SENSITIVITY_STEP_COUNT; i++){
-            if((mouse_change_y > SLOWMO_ANGLE_DEFLECTION[i]) && (mouse_change_y <= SLOWMO_ANGLE_DEFLECTION[i+1])){
-                mouse_move_y = (int)((mouse_change_y * SLOWMO_SENSITIVITY[i][sensitivity_level]) / 20000);
-                break;
-            }
-            else if((mouse_change_y > -SLOWMO_ANGLE_DEFLECTION[i+1]) && (mouse_change_y <= -SLOWMO_ANGLE_DEFLECTION[i])){
-                mouse_move_y = (int)((mouse_change_y * SLOWMO_SENSITIVITY[i][sensitivity_level]) / 20000);
-                break;
-            }
+    else if(action == DEVICE_CONN_AND_CONFIG){
+        if(!is_long){
+            bleMouse.connectNewDevice();
+            log_message(LOG_INFO, "BLE advertising started...");
+        }
+        else{
+            /* TODO: Enter Wifi config mode here*/
+            log_message(LOG_INFO, "Button %d startpress  - config mode work in progress ",  i);
         }
     }
-    /* Normal operation: adjust mouse movement to chosen sensitivity level */
-    else{   
-        mouse_move_y = (int)((mouse_change_y * _preferences.sensititvity) / 20000);
-    }
-    log_message(LOG_DEBUG_IMU, "move y: %d", mouse_move_y);
-    //log_message(LOG_DEBUG_IMU, "sensitivity: %d", _preferences.sensititvity);
-#ifdef GRAD
-    /* X-AXIS DATA PROCESSING *******************/
-    /* Process Euler Angle data */
-    if((new_imu_data.orientation.x > 359.5) && (imu_data.orientation.x < 0.5)){         // Guard edge case
-        mouse_change_x = (int64_t)(SCALING_FACTOR*((new_imu_data.orientation.x - 360.0) - imu_data.orientation.x));
+    else if(action == DRAG_LOCK){
+        if(_hid_output.isPressed(MOUSE_LEFT)) _hid_output.release(MOUSE_LEFT, gesture.timestamp_us);
+        else _hid_output.press(MOUSE_LEFT, gesture.timestamp_us);
+        log_message(LOG_INFO, "Button %d drag lock %d ",  i, _hid_output.isPressed(MOUSE_LEFT));
     }
-    else if((new_imu_data.orientation.x < 0.5) && (imu_data.orientation.x > 359.5)){    // Guard edge case
-        mouse_change_x = (int64_t)(SCALING_FACTOR*(new_imu_data.orientation.x - (imu_data.orientation.x - 360.0)));
+    else if(action == DOUBLE_CLICK){
+        _hid_output.click(MOUSE_LEFT, gesture.timestamp_us);
+        _hid_output.click(MOUSE_LEFT, gesture.timestamp_us);
+        log_message(LOG_INFO, "Button %d double click ",  i);
     }
-    else{
-        mouse_change_x = (int64_t)(SCALING_FACTOR*(new_imu_data.orientation.x - imu_data.orientation.x)); 
+    else if(action == RECENTER){
+        recenter();
+        log_message(LOG_INFO, "Button %d recentre ",  i);
     }
+}
+
+/************************************************************
+ * @brief Update IMU sample statistics.
+ *
+ * Compares the data ready interrupts with the reads to find 
+ * duplicate and skipped fusion samples and records the age of 
+ * the sample read.
+ *
+ * @param read_us Time of the read [us].
+ *************************************************************/
+void HeadMouse::_updateSampleStats(uint32_t read_us){
+    HmSampleStats& stats = _cycle_stats.sample;
+    uint32_t count = _sample_ready_count;
+    uint32_t ready_us = _sample_ready_us;
 
-    /* Add jitter-offset to stabalize mouse when head is not moving */
-    if((mouse_change_x >= -JITTER_OFFSET) && (mouse_change_x <= JITTER_OFFSET)){
-        mouse_move_x = 0;  
+    if(count == _samples_read){
+        stats.duplicates++;
+        return;
     }
-    /* Enter slow-motion mode if mouse is moving slowly to improve positioning accuracy */
-    else if((mouse_change_x >= -SLOW_MOTION_OFFSET) && (mouse_change_x <= SLOW_MOTION_OFFSET)){
-        for(int i=0; i<SENSITIVITY_STEP_COUNT; i++){
-            if((mouse_change_x > SLOWMO_ANGLE_DEFLECTION[i]) && (mouse_change_x <= SLOWMO_ANGLE_DEFLECTION[i+1])){
-                mouse_move_x = (int)((mouse_change_x * SLOWMO_SENSITIVITY[i][sensitivity_level]) / SCALING_FACTOR);
-                break;
-            }
-            else if((mouse_change_x > -SLOWMO_ANGLE_DEFLECTION[i+1]) && (mouse_change_x <= -SLOWMO_ANGLE_DEFLECTION[i])){
-                mouse_move_x = (int)((mouse_change_x * SLOWMO_SENSITIVITY[i][sensitivity_level]) / SCALING_FACTOR);
-                break;
-            }
-        }
+    stats.skipped += count - _samples_read - 1;
+    _samples_read = count;
+
+    uint32_t age_us = read_us - ready_us;
+    uint32_t bucket = age_us / SAMPLE_AGE_BUCKET_US;
+    stats.samples++;
+    stats.age_sum_us += age_us;
+    if(age_us > stats.age_max_us) stats.age_max_us = age_us;
+    stats.age_histogram[(bucket < SAMPLE_AGE_BUCKET_COUNT) ? bucket : SAMPLE_AGE_BUCKET_COUNT - 1]++;
+}
+
+/************************************************************
+ * @brief Calculate head rotation since last cycle in fixed-point
+ *        from the raw BNO055 quaternion.
+ *
+ * Computes the relative rotation q_prev^-1 * q_new in Q28 integer
+ * arithmetic (small-angle approximation) and converts the body
+ * rates to Euler angle rates, so the output matches the Euler
+ * engine without any trigonometric, floating point or 64-bit
+ * operations:
+ *   yaw'  = (w_y*R32 + w_z*R33) / cos^2(pitch)
+ *   roll' = w_x - yaw'*R31
+ * with Rij being elements of the current rotation matrix (Q12).
+ *
+ * @param quat Current raw orientation quaternion (Q14).
+ * @param change_x Output: horizontal rotation [RAD]*2^MOTION_Q_SHIFT.
+ * @param change_y Output: vertical rotation [RAD]*2^MOTION_Q_SHIFT.
+ *************************************************************/
+void HeadMouse::_motionDeltaFixed(const int16_t* quat, int32_t* change_x, int32_t* change_y){
+    static constexpr int32_t COS2_MIN = 1 << 6;    // Limit gain near +-90 deg pitch (cos^2 >= 1/64)
+    static bool first_run = true;
+    static int32_t prev_w, prev_x, prev_y, prev_z;
+    int32_t w = quat[0];
+    int32_t x = quat[1];
+    int32_t y = quat[2];
+    int32_t z = quat[3];
+
+    if(first_run){
+        first_run = false;
+        prev_w = w; prev_x = x; prev_y = y; prev_z = z;
     }
-    /* Normal operation: adjust mouse movement to chosen sensitivity level */
-    else{   
-        mouse_move_x = (int)((mouse_change_x * _preferences.sensititvity) / SCALING_FACTOR);
+
+    /* Relative rotation q_rel = conj(q_prev) * q_new [Q28] */
+    int32_t rel_w = prev_w*w + prev_x*x + prev_y*y + prev_z*z;
+    int32_t rel_x = prev_w*x - prev_x*w - prev_y*z + prev_z*y;
+    int32_t rel_y = prev_w*y + prev_x*z - prev_y*w - prev_z*x;
+    int32_t rel_z = prev_w*z - prev_x*y + prev_y*x - prev_z*w;
+    prev_w = w; prev_x = x; prev_y = y; prev_z = z;
+
+    /* Take shortest path, q and -q describe the same orientation */
+    if(rel_w < 0){
+        rel_x = -rel_x; rel_y = -rel_y; rel_z = -rel_z;
     }
-    /* Y-AXIS DATA PROCESSING *******************/
-    /* Process Euler Angle data - IMU z-axis is translated into display y-axis; No special edge case guard needed */
-    mouse_change_y = (int64_t)(SCALING_FACTOR*(imu_data.orientation.z - new_imu_data.orientation.z));  
 
-    /* Add jitter-offset to stabalize mouse when head is not moving */
-    if((mouse_change_y >= -JITTER_OFFSET) && (mouse_change_y <= JITTER_OFFSET)){
-        mouse_move_y = 0;  
-    } 
-    /* Enter slow-motion mode if mouse is moving slowly to improve positioning accuracy */
-    else if((mouse_change_y >= -SLOW_MOTION_OFFSET) && (mouse_change_y <= SLOW_MOTION_OFFSET)){
-        for(int i=0; i<SENSITIVITY_STEP_COUNT; i++){
-            if((mouse_change_y > SLOWMO_ANGLE_DEFLECTION[i]) && (mouse_change_y <= SLOWMO_ANGLE_DEFLECTION[i+1])){
-                mouse_move_y = (int)((mouse_change_y * SLOWMO_SENSITIVITY[i][sensitivity_level]) / SCALING_FACTOR);
-                break;
-            }
-            else if((mouse_change_y > -SLOWMO_ANGLE_DEFLECTION[i+1]) && (mouse_change_y <= -SLOWMO_ANGLE_DEFLECTION[i])){
-                mouse_move_y = (int)((mouse_change_y * SLOWMO_SENSITIVITY[i][sensitivity_level]) / SCALING_FACTOR);
-                break;
-            }
-        }
+    /* Body rates: rotation vector = 2 * vector part [Q28 -> Q20] */
+    int32_t omega_x = _clampMotion(rel_x >> (28 - 1 - MOTION_Q_SHIFT));
+    int32_t omega_y = _clampMotion(rel_y >> (28 - 1 - MOTION_Q_SHIFT));
+    int32_t omega_z = _clampMotion(rel_z >> (28 - 1 - MOTION_Q_SHIFT));
+
+    /* Rotation matrix elements of current orientation [Q28 -> Q12] */
+    int32_t r31 = (x*z - w*y) >> 15;                /* -sin(pitch) */
+    int32_t r32 = (y*z + w*x) >> 15;                /* cos(pitch)*sin(roll) */
+    int32_t r33 = (w*w - x*x - y*y + z*z) >> 16;    /* cos(pitch)*cos(roll) */
+    int32_t cos2 = (1 << 12) - ((r31 * r31) >> 12);
+    if(cos2 < COS2_MIN) cos2 = COS2_MIN;
+
+    /* Euler angle rates [Q32 / Q12 -> Q20] */
+    int32_t yaw = _clampMotion((omega_y*r32 + omega_z*r33) / cos2);
+    int32_t roll = _clampMotion(omega_x - ((yaw * r31) >> 12));
+
+    /* Same sign convention as Euler engine: X = -yaw, Y = +roll */
+    *change_x = -yaw;
+    *change_y = roll;
+}
+
+/************************************************************
+ * @brief Log program cycle statistics.
+ *
+ * CPU shares are given in permille of the time since the last 
+ * statistics reset.
+ *************************************************************/
+void HeadMouse::_logCycleStats(){
+    uint64_t elapsed_us = (uint64_t)(esp_timer_get_time() - _cycle_stats.start_us);
+    uint32_t share[CYCLE_TASK_COUNT] = {0};
+
+    for(int i=0; i<CYCLE_TASK_COUNT; i++){
+        if(elapsed_us > 0) share[i] = (uint32_t)((_cycle_stats.task_us[i] * 1000) / elapsed_us);
     }
-    /* Normal operation: adjust mouse movement to chosen sensitivity level */
-    else{       
-        mouse_move_y =  (int)((mouse_change_y * _preferences.sensititvity) / SCALING_FACTOR);
+    log_message(LOG_DEBUG_CYCLE, "cycles: %lu, missed ticks: %lu, coalesced: %lu, max: %luus", (unsigned long)_cycle_stats.cycles, 
+                (unsigned long)_cycle_stats.missed_ticks, (unsigned long)_cycle_stats.coalesced_cycles, (unsigned long)_cycle_stats.cycle_max_us);
+    log_message(LOG_DEBUG_CYCLE, "CPU share [permille] status: %lu, sensor: %lu, motion: %lu, hid: %lu, buttons: %lu", (unsigned long)share[CYCLE_DEV_STATUS], 
+                (unsigned long)share[CYCLE_SENSOR], (unsigned long)share[CYCLE_MOTION], (unsigned long)share[CYCLE_HID], 
+                (unsigned long)share[CYCLE_BTN_ACTIONS]);
+    if((_cycle_stats.dropped_samples > 0) || (_cycle_stats.dropped_moves > 0)){
+        log_message(LOG_DEBUG_CYCLE, "dropped samples: %lu, moves: %lu", (unsigned long)_cycle_stats.dropped_samples, 
+                    (unsigned long)_cycle_stats.dropped_moves);
     }
-    #endif  
-    /* Update imu data buffer for later on comparison */
-    euler.x() = new_euler.x();
-    euler.z() = new_euler.z();  
 
-    /* Move mouse cursor */
-    if(_status.is_connected){       
-        if((mouse_move_x != 0) || (mouse_move_y != 0)){
-            bleMouse.move((unsigned char)(mouse_move_x), (unsigned char)(mouse_move_y),0);  
-            log_message(LOG_DEBUG_IMU, "move x: %d", mouse_move_x);
-            log_message(LOG_DEBUG_IMU, "move y: %d", mouse_move_y);
-        }
+    for(int i=0; i<JOB_COUNT; i++){
+        HmJobStats job = _scheduler.getStats(i);
+        log_message(LOG_DEBUG_CYCLE, "job %s: runs: %lu, deadline misses: %lu, max: %luus", job.name, (unsigned long)job.runs, 
+                    (unsigned long)job.deadline_misses, (unsigned long)job.run_max_us);
     }
-    else{
-        return ERR_CONNECTION_FAILED;
+#ifdef HM_TRACE_TASKS
+    HmTaskTrace trace = TaskTrace::get();
+    log_message(LOG_DEBUG_CYCLE, "core load [permille] 0: %lu, 1: %lu, motion runs: %lu, cores: 0x%lx, preempted: %lu, run max: %luus, wake mean: %luus, max: %luus",
+                (unsigned long)trace.core_load[0], (unsigned long)trace.core_load[1], (unsigned long)trace.motion_runs, 
+                (unsigned long)trace.motion_core_mask, (unsigned long)trace.motion_preempted, (unsigned long)trace.motion_run_max_us,
+                (unsigned long)((trace.motion_runs > 0) ? (trace.motion_wake_sum_us / trace.motion_runs) : 0), (unsigned long)trace.motion_wake_max_us);
+#endif
+
+    const HmSampleStats& sample = _cycle_stats.sample;
+    if(sample.samples > 0){
+        log_message(LOG_DEBUG_CYCLE, "samples: %lu, duplicates: %lu, skipped: %lu, age mean: %luus, max: %luus", (unsigned long)sample.samples,
+                    (unsigned long)sample.duplicates, (unsigned long)sample.skipped, (unsigned long)(sample.age_sum_us / sample.samples),
+                    (unsigned long)sample.age_max_us);
     }
-   
+    const HmHidStats& hid = _cycle_stats.hid;
+    log_message(LOG_DEBUG_CYCLE, "hid reports: %lu, merged: %lu, dropped: %lu, split: %lu", (unsigned long)hid.reports, (unsigned long)hid.merged,
+                (unsigned long)hid.dropped, (unsigned long)hid.split);
+    const HmButtonStats& button = _cycle_stats.button;
+    if((button.events > 0) || (button.dropped > 0)){
+        log_message(LOG_DEBUG_CYCLE, "button events: %lu, dropped: %lu, reports: %lu, latency mean: %luus, max: %luus", (unsigned long)button.events,
+                    (unsigned long)button.dropped, (unsigned long)button.reports, 
+                    (unsigned long)((button.reports > 0) ? (button.latency_sum_us / button.reports) : 0), (unsigned long)button.latency_max_us);
+    }
+}
 
-    return ERR_NONE;
+/************************************************************
+ * @brief Get the interval since the previous IMU sample.
+ *
+ * @param timestamp_us Time of the current IMU sample [us].
+ * @return Sample interval [us], limited to MOTION_DT_MIN_US..
+ *         MOTION_DT_MAX_US. Nominal interval for the first sample.
+ *************************************************************/
+uint32_t HeadMouse::_sampleInterval(int64_t timestamp_us){
+    int64_t dt_us = (_imu_timestamp_us != 0) ? (timestamp_us - _imu_timestamp_us) : (int64_t)PROGRAM_CYCLE_INTERVAL_MS*1000;
+    _imu_timestamp_us = timestamp_us;
+
+    if(dt_us < MOTION_DT_MIN_US) return MOTION_DT_MIN_US;
+    if(dt_us > MOTION_DT_MAX_US) return MOTION_DT_MAX_US;
+    return (uint32_t)dt_us;
 }
 
 /************************************************************
- * @brief Update button actions.
+ * @brief Get the index of the active sensitivity level.
  *
- * This function checks the button states and performs the
- * corresponding actions based on clicks or presses.
+ * @return Index of PREF_SENSITIVITY, 0 if the sensitivity is not 
+ *         one of the levels.
  *************************************************************/
-/* TODO */
-void HeadMouse::updateBtnActions(){
-    static bool is_press_buf[BUTTON_COUNT] = {0};
-    
-    for(int i=0; i<BUTTON_COUNT; i++){
-        /* Check for left/right mouse button action */
-        if((_preferences.btn_actions[i]==RIGHT) || (_preferences.btn_actions[i]==LEFT)){
-            if(_buttons->is_click[i]){  /* CLICK */
-                bleMouse.click(_preferences.btn_actions[i]);
-                _buttons->is_click[i] = false;
-                log_message(LOG_INFO, "Button %d clicked ",  i);
-            }
-            /* Check if button is pressed/released */
-            if(_buttons->is_press[i] && !is_press_buf[i]){ /* PRESS */
-                bleMouse.press(_preferences.btn_actions[i]);
-                is_press_buf[i] = true;
-                log_message(LOG_INFO, "Button %d start press ",  i);
-            }
-            else if(!_buttons->is_press[i] && is_press_buf[i]){ /* RELEASE */
-                bleMouse.release(_preferences.btn_actions[i]);
-                is_press_buf[i] = false;
-                log_message(LOG_INFO, "Button %d stop press ",  i);
-            }
-        }
-        else if(_preferences.btn_actions[i] == SENSITIVITY){
-            if(_buttons->is_click[i]){
-                if(_preferences.sensititvity == SENSITIVITY_MAX){
-                    _preferences.sensititvity = SENSITIVITY_MIN;
-                }
-                else{ _preferences.sensititvity += SENSITIVITY_STEP;}
-                
-                setSensitivity(_preferences.sensititvity);
-                _buttons->is_click[i] = false;
-            }
-        }
-        else if(_preferences.btn_actions[i] == DEVICE_CONN_AND_CONFIG){
-            if(_buttons->is_click[i]){
-                bleMouse.connectNewDevice();
-                log_message(LOG_INFO, "BLE advertising started...");
-                _buttons->is_click[i] = false;
-            }
-            /* Check if button is pressed/released */
-            if(_buttons->is_press[i] && !is_press_buf[i]){ /* PRESS */
-                /* TODO: Enter Wifi config mode here*/
-                log_message(LOG_INFO, "Button %d startpress  - config mode work in progress ",  i);
-                is_press_buf[i] = true;
-            }
-            else if(!_buttons->is_press[i] && is_press_buf[i]){ /* RELEASE */
-                is_press_buf[i] = false;
-                log_message(LOG_INFO, "Button %d stop press ",  i);
-            }
-        }
+uint32_t HeadMouse::_sensitivityLevel(){
+    for(uint32_t i=0; i<SENSITIVITY_STEP_COUNT; i++){
+        if(PREF_SENSITIVITY[i] == _preferences.sensititvity) return i;
     }
+    return 0;
 }
 
-/* SETTER */
-
 /************************************************************
- * @brief Set HeadMouse device preferences.
+ * @brief Precompute the pointer acceleration curve of the
+ *        active sensitivity level.
  *
- * This function sets the various preferences for the HeadMouse
- * device, including mode, sensitivity, and button actions.
- *
- * @param preferences Struct containing device preferences.
+ * Falls back to the default curve of the level if the configured
+ * curve is invalid. The table is built in the inactive buffer and
+ * swapped in afterwards, so the motion task never sees a partly
+ * built curve. Rebuilds in a row wait until the motion stage has
+ * left the inactive buffer, which takes at most one sample.
  *************************************************************/
-void HeadMouse::setPreferences(HmPreferences preferences){
-    setMode(preferences.mode);
-    setSensitivity(preferences.sensititvity);
-    setButtonActions(preferences.btn_actions);
+void HeadMouse::_updateMotionCurve(){
+    uint32_t level = _sensitivityLevel();
+    uint32_t index = _motion_curve_index.load() ^ 1;
+
+    while(_motion_curve_in_use.load() == index){}
+    if(!_motion_curves[index].build(_preferences.curves[level])){
+        log_message(LOG_WARNING, "Invalid motion curve %d, using default", level);
+        _motion_curves[index].build(MOTION_CURVE_DEFAULT[level]);
+    }
+    _motion_curve_index.store(index);
 }
 
 /************************************************************
- * @brief Set HeadMouse motion sensitivity.
+ * @brief Start a program cycle if a timer tick is pending.
  *
- * This function sets the sensitivity level for head motion
- * detection.
+ * Ticks that elapse while a cycle is still running are coalesced
+ * into the next cycle and counted as missed.
  *
- * @param sensitivity Sensititvity level for head motion detection.
+ * @return TRUE if a program cycle has been started, FALSE otherwise.
+ *************************************************************/
+bool HeadMouse::_startProgramCycle(){
+    uint32_t ticks = _program_cycle_ticks;
+
+    if(ticks == _ticks_handled) return false;
+
+    uint32_t pending = ticks - _ticks_handled;
+    _ticks_handled = ticks;
+    if(pending > 1){
+        _cycle_stats.missed_ticks += pending - 1;
+        _cycle_stats.coalesced_cycles++;
+    }
+    _cycle_stats.cycles++;
+    _cycle_start_us = esp_timer_get_time();
+    return true;
+}
+
+/************************************************************
+ * @brief Finish a program cycle and update its worst-case time.
+ *
+ * @param cycle_start_us Start of the program cycle [us].
+ *************************************************************/
+void HeadMouse::_endProgramCycle(int64_t cycle_start_us){
+    uint32_t cycle_us = (uint32_t)(esp_timer_get_time() - cycle_start_us);
+
+    if(cycle_us > _cycle_stats.cycle_max_us) _cycle_stats.cycle_max_us = cycle_us;
+#if LOG_LEVEL_DEBUG_CYCLE
+    if((_cycle_stats.cycles % CYCLE_STATS_LOG_INTERVAL) == 0) _logCycleStats();
+#endif
+}
+
+/************************************************************
+ * @brief Read a new IMU sample (sensor stage).
+ *
+ * @param sample Output: raw quaternion, time of the read and start
+ *               of the program cycle.
+ * @return TRUE on success, FALSE if the BNO055 could not be read.
+ *************************************************************/
+bool HeadMouse::_readSample(ImuSample* sample){
+    CycleTaskTimer task_timer(_cycle_stats, CYCLE_SENSOR);
+
+    /* Re-arm the latched data ready interrupt before reading, so the next fusion sample raises a new edge */
+    if(_sample_int_enabled) _writeBnoRegister(BNO055_SYS_TRIGGER_REG, BNO055_RST_INT);
+
+    if(!_readRawQuat(sample->quat)){
+        log_message(LOG_WARNING, "Cannot read BNO055 quaternion");
+        return false;
+    }
+    sample->timestamp_us = esp_timer_get_time();
+    sample->cycle_start_us = _cycle_start_us;
+    if(_sample_int_enabled) _updateSampleStats((uint32_t)sample->timestamp_us);
+#if LOG_LEVEL_TRACE_IMU
+    /* Raw BNO055 quaternion (1 LSB = 2^-14) for host replay traces */
+    log_message(LOG_TRACE_IMU, "%lu,%d,%d,%d,%d", (unsigned long)sample->timestamp_us, sample->quat[0], sample->quat[1], 
+                sample->quat[2], sample->quat[3]);
+#endif
+    return true;
+}
+
+/************************************************************
+ * @brief Translate an IMU sample into a mouse movement (motion
+ *        stage).
+ *
+ * Calculates the head rotation since the last sample with the 
+ * selected motion engine and applies the pointer acceleration 
+ * curve. In absolute mode (HM_HID_ABSOLUTE only) the head pose
+ * is mapped to a screen position instead, the motion engine still
+ * runs to stay in step for a switch back to relative mode.
+ * In scroll mode the head rotation is mapped to the wheels along
+ * the scroll curve, without moving the pointer.
+ *
+ * @param sample IMU sample.
+ * @return Mouse movement [counts], screen position or wheel 
+ *         movement.
+ *************************************************************/
+MouseMove HeadMouse::_processSample(const ImuSample& sample){
+    CycleTaskTimer task_timer(_cycle_stats, CYCLE_MOTION);
+    int32_t mouse_change_x = 0;
+    int32_t mouse_change_y = 0;
+    int mouse_move_x = 0;
+    int mouse_move_y = 0;
+    uint32_t velocity_scale = 0;
+    uint32_t curve_index = 0;
+
+    /* Calculate head rotation since last cycle */
+#ifdef HM_MOTION_ENGINE_FIXED
+    _motionDeltaFixed(sample.quat, &mouse_change_x, &mouse_change_y);
+#else
+    imu::Quaternion quat(QUAT_RAW_SCALE*sample.quat[0], QUAT_RAW_SCALE*sample.quat[1], 
+                         QUAT_RAW_SCALE*sample.quat[2], QUAT_RAW_SCALE*sample.quat[3]);
+#ifdef HM_MOTION_ENGINE_QUAT
+    _motionDeltaQuat(quat, &mouse_change_x, &mouse_change_y);
+#else
+    _motionDeltaEuler(quat, &mouse_change_x, &mouse_change_y);
+#endif
+#endif
+    log_message(LOG_DEBUG_IMU, "mouse change x: %d", mouse_change_x);
+    log_message(LOG_DEBUG_IMU, "mouse change y: %d", mouse_change_y);
+
+    /* Translate head rotation into mouse movement along the pointer acceleration curve */
+    velocity_scale = ((uint32_t)1000000 << VELOCITY_SCALE_SHIFT) / _sampleInterval(sample.timestamp_us);
+    if(_is_scrolling.load()){
+        /* Scroll mode: the dominant axis scrolls along the scroll curve, the pointer stays */
+        int32_t wheel = 0;
+        int32_t pan = 0;
+        if(abs(mouse_change_y) >= abs(mouse_change_x)){
+            wheel = -_motionCurve(mouse_change_y, velocity_scale, _scroll_curve, SCROLL_DEADBAND_VELOCITY_Q, &_scroll_residual_y);
+        }
+        else{
+            pan = _motionCurve(mouse_change_x, velocity_scale, _scroll_curve, SCROLL_DEADBAND_VELOCITY_Q, &_scroll_residual_x);
+        }
+        log_message(LOG_DEBUG_IMU, "wheel: %d", wheel);
+        log_message(LOG_DEBUG_IMU, "pan: %d", pan);
+        return {sample.cycle_start_us, 0, 0, false, wheel, pan};
+    }
+#ifdef HM_HID_ABSOLUTE
+    if(_preferences.mode == ABSOLUTE){
+        uint32_t level = _sensitivityLevel();
+        int32_t position_x = 0;
+        int32_t position_y = 0;
+        if(_abs_recenter.exchange(false)) _abs_pointer.recenter(sample.quat);
+        _abs_pointer.setRange(ABS_RANGE_X_MRAD[level], ABS_RANGE_Y_MRAD[level]);
+        _abs_pointer.map(sample.quat, &position_x, &position_y);
+        log_message(LOG_DEBUG_IMU, "position x: %d", position_x);
+        log_message(LOG_DEBUG_IMU, "position y: %d", position_y);
+        return {sample.cycle_start_us, position_x, position_y, true, 0, 0};
+    }
+#endif
+    /* Mark the published curve in use before reading it, re-check in case it was swapped meanwhile */
+    do{
+        curve_index = _motion_curve_index.load();
+        _motion_curve_in_use.store(curve_index);
+    } while(_motion_curve_index.load() != curve_index);
+    mouse_move_x = _motionCurve(mouse_change_x, velocity_scale, _motion_curves[curve_index], JITTER_VELOCITY_Q, &_motion_residual_x);
+    mouse_move_y = _motionCurve(mouse_change_y, velocity_scale, _motion_curves[curve_index], JITTER_VELOCITY_Q, &_motion_residual_y);
+    _motion_curve_in_use.store(MOTION_CURVE_NONE);
+    log_message(LOG_DEBUG_IMU, "move x: %d", mouse_move_x);
+    log_message(LOG_DEBUG_IMU, "move y: %d", mouse_move_y);
+    //log_message(LOG_DEBUG_IMU, "sensitivity: %d", _preferences.sensititvity);
+
+    return {sample.cycle_start_us, mouse_move_x, mouse_move_y, false, 0, 0};
+}
+
+/************************************************************
+ * @brief Pass a mouse movement to the HID output (HID stage).
+ *
+ * The movement is sent with the next HID report, see 
+ * _sendHidReport(). An absolute position replaces the pending one.
+ * Wheel movements are reduced to whole detents unless the host has
+ * enabled the high-resolution wheel (HM_HID_HIRES_WHEEL), the rest
+ * is carried to the next movement.
+ *
+ * @param move Mouse movement [counts] or screen position.
+ * @return ERR_CONNECTION_FAILED if no host is connected, ERR_NONE 
+ *         otherwise.
+ *************************************************************/
+err HeadMouse::_sendMove(const MouseMove& move){
+    CycleTaskTimer task_timer(_cycle_stats, CYCLE_HID);
+
+    /* Move mouse cursor */
+    if(_status.is_connected){       
+        if(move.is_absolute){
+            if(_hid_output.moveTo(move.x, move.y)) _hid_moves.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if((move.x != 0) || (move.y != 0)){
+            _hid_output.move(move.x, move.y);
+            _hid_moves.fetch_add(1, std::memory_order_relaxed);
+            log_message(LOG_DEBUG_IMU, "move x: %d", move.x);
+            log_message(LOG_DEBUG_IMU, "move y: %d", move.y);
+        }
+        if((move.wheel != 0) || (move.pan != 0)){
+            /* The absolute report has no resolution multiplier */
+            int32_t wheel_step = WHEEL_HIRES_MULTIPLIER / (_hid_output.isAbsolute() ? 1 : bleMouse.getWheelMultiplier());
+            int32_t pan_step = WHEEL_HIRES_MULTIPLIER / (_hid_output.isAbsolute() ? 1 : bleMouse.getPanMultiplier());
+            _wheel_residual += move.wheel;
+            _pan_residual += move.pan;
+            int32_t wheel = _wheel_residual / wheel_step;
+            int32_t pan = _pan_residual / pan_step;
+            _wheel_residual -= wheel * wheel_step;
+            _pan_residual -= pan * pan_step;
+            if((wheel != 0) || (pan != 0)){
+                _hid_output.move(0, 0, wheel, pan);
+                _hid_moves.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    else{
+        return ERR_CONNECTION_FAILED;
+    }
+
+    return ERR_NONE;
+}
+
+/************************************************************
+ * @brief Send the pending movements and button transitions as one
+ *        HID report, at most once per connection interval.
+ *
+ * Sending more often would only queue notifications in the BLE
+ * stack until the next connection event. The interval follows the
+ * negotiated connection parameters. Movements too large for
+ * one report are completed by extra reports, so the cursor never
+ * moves less or in the wrong direction.
+ *************************************************************/
+void HeadMouse::_sendHidReport(){
+    CycleTaskTimer task_timer(_cycle_stats, CYCLE_HID);
+    HidReport report;
+    uint32_t dropped = _hid_output.getDropped();
+    uint32_t interval_us = bleMouse.getConnInterval() * BLE_CONN_INTERVAL_UNIT_US;
+
+    _cycle_stats.hid.dropped += dropped - _hid_dropped_seen;
+    _hid_dropped_seen = dropped;
+
+    if(!_status.is_connected){
+        _hid_output.clear();
+        return;
+    }
+    if(interval_us == 0) interval_us = HID_REPORT_INTERVAL_DEF_US;
+    if(interval_us != _hid_output.getInterval()) _hid_output.setInterval(interval_us);
+    while(_hid_output.popReport(esp_timer_get_time(), &report)){
+#ifdef HM_HID_ABSOLUTE
+        if(report.is_absolute) bleMouse.reportAbsolute(report.buttons, report.x, report.y, (signed char)report.wheel, (signed char)report.pan);
+        else bleMouse.report(report.buttons, report.x, report.y, (signed char)report.wheel, (signed char)report.pan);
+#else
+        bleMouse.report(report.buttons, report.x, report.y, (signed char)report.wheel, (signed char)report.pan);
+#endif
+        _cycle_stats.hid.reports++;
+        if(report.is_split) _cycle_stats.hid.split++;
+        if(report.requests > 1) _cycle_stats.hid.merged += report.requests - 1;
+        if(report.source_us != 0) _updateButtonStats(report.source_us);
+    }
+}
+
+/* TASKS ************************************************************/
+
+/************************************************************
+ * @brief Sensor task: read the IMU once per program cycle.
+ *
+ * Woken by the program cycle timer or the BNO055 data ready 
+ * interrupt. Hands the sample over to the motion task.
+ *
+ * @param arg HeadMouse instance.
+ *************************************************************/
+void HeadMouse::_taskSensor(void* arg){
+    HeadMouse* hm = (HeadMouse*)arg;
+    ImuSample sample;
+
+    while(taskIsRunning()){
+        if(!_sensor_signal.take(TASK_WAIT_TIMEOUT_MS)) continue;
+        if(!hm->_startProgramCycle() || !hm->_readSample(&sample)) continue;
+
+        if(!hm->_sample_queue.push(sample)) hm->_cycle_stats.dropped_samples++;
+#ifdef HM_TRACE_TASKS
+        TaskTrace::motionSignaled();
+#endif
+        _motion_signal.give();
+    }
+}
+
+/************************************************************
+ * @brief Motion task: translate IMU samples into mouse movements.
+ *
+ * @param arg HeadMouse instance.
+ *************************************************************/
+void HeadMouse::_taskMotion(void* arg){
+    HeadMouse* hm = (HeadMouse*)arg;
+    ImuSample sample;
+
+    while(taskIsRunning()){
+        if(!_motion_signal.take(TASK_WAIT_TIMEOUT_MS)) continue;
+#ifdef HM_TRACE_TASKS
+        int64_t trace_start_us = TaskTrace::now();
+#endif
+
+        while(hm->_sample_queue.pop(&sample)){
+            if(!hm->_move_queue.push(hm->_processSample(sample))) hm->_cycle_stats.dropped_moves++;
+            _hid_signal.give();
+        }
+#ifdef HM_TRACE_TASKS
+        TaskTrace::motionRun(trace_start_us);
+#endif
+    }
+}
+
+/************************************************************
+ * @brief HID task: send mouse movements and button actions.
+ *
+ * Owns all BLE mouse reports. A program cycle ends when its 
+ * movement has been passed to the HID output. Buttons are checked
+ * after every movement, at the latest after TASK_WAIT_TIMEOUT_MS,
+ * and the task wakes up when a pending HID report is due.
+ *
+ * @param arg HeadMouse instance.
+ *************************************************************/
+void HeadMouse::_taskHid(void* arg){
+    HeadMouse* hm = (HeadMouse*)arg;
+    MouseMove move;
+
+    while(taskIsRunning()){
+        _hid_signal.take(hm->_hid_output.getWaitMs(esp_timer_get_time(), TASK_WAIT_TIMEOUT_MS));
+
+        while(hm->_move_queue.pop(&move)){
+            hm->_sendMove(move);
+            hm->_endProgramCycle(move.cycle_start_us);
+        }
+        hm->updateBtnActions();
+        hm->_sendHidReport();
+    }
+}
+
+/************************************************************
+ * @brief Housekeeping task: device status, battery and LEDs.
+ *
+ * Runs the due device status jobs on every program cycle timer
+ * tick with the lowest priority, so slow I2C or ADC reads never 
+ * delay the movements.
+ *
+ * @param arg HeadMouse instance.
+ *************************************************************/
+void HeadMouse::_taskHousekeeping(void* arg){
+    HeadMouse* hm = (HeadMouse*)arg;
+
+    while(taskIsRunning()){
+        if(!_housekeeping_signal.take(TASK_WAIT_TIMEOUT_MS)) continue;
+        hm->_scheduler.run(_timer_ticks);
+    }
+}
+
+/* JOBS *************************************************************/
+
+/************************************************************
+ * @brief Trigger the LED job if the device status has changed.
+ *
+ * @param old_status Device status before the update.
+ *************************************************************/
+void HeadMouse::_triggerLedsOnChange(const HmStatus& old_status){
+    if((_status.is_error != old_status.is_error) || (_status.is_connected != old_status.is_connected) ||
+       (_status.is_charging != old_status.is_charging) || (_status.is_calibrated != old_status.is_calibrated) ||
+       (_status.bat_status != old_status.bat_status)){
+        _scheduler.trigger(JOB_LEDS);
+    }
+}
+
+/************************************************************
+ * @brief Add the jobs of HmJob to the scheduler.
+ *
+ * The LED job is triggered once, so the LEDs show the initial
+ * device status.
+ *************************************************************/
+void HeadMouse::_initJobs(){
+    if(_scheduler.getJobCount() == 0){
+        _scheduler.addJob("motion", JOB_PERIOD_MOTION_MS / PROGRAM_CYCLE_INTERVAL_MS, _jobMotion, this);
+        _scheduler.addJob("status", JOB_PERIOD_STATUS_MS / PROGRAM_CYCLE_INTERVAL_MS, _jobStatus, this);
+        _scheduler.addJob("calibration", JOB_PERIOD_CALIBRATION_MS / PROGRAM_CYCLE_INTERVAL_MS, _jobCalibration, this);
+        _scheduler.addJob("battery", JOB_PERIOD_BATTERY_MS / PROGRAM_CYCLE_INTERVAL_MS, _jobBattery, this);
+        _scheduler.addJob("leds", JOB_ON_EVENT, _jobLeds, this);
+    }
+    _scheduler.trigger(JOB_LEDS);
+    _scheduler.start(_ticks_handled);
+}
+
+/************************************************************
+ * @brief Motion job: button actions and movements.
+ *
+ * @param arg HeadMouse instance.
+ *************************************************************/
+void HeadMouse::_jobMotion(void* arg){
+    HeadMouse* hm = (HeadMouse*)arg;
+
+    hm->updateBtnActions();
+    hm->updateMovements();     // Sends the button transitions along
+}
+
+/************************************************************
+ * @brief Status job: BLE connection and battery charging state.
+ *
+ * @param arg HeadMouse instance.
+ *************************************************************/
+void HeadMouse::_jobStatus(void* arg){
+    HeadMouse* hm = (HeadMouse*)arg;
+    CycleTaskTimer task_timer(hm->_cycle_stats, CYCLE_DEV_STATUS);
+    HmStatus old_status = hm->_status;
+
+    hm->_status.is_connected = hm->isConnected();
+    hm->_status.is_charging = hm->isCharging();
+    hm->_updateConnParams();
+    hm->_triggerLedsOnChange(old_status);
+}
+
+/************************************************************
+ * @brief Request BLE connection parameters fitting the head motion.
+ *
+ * Short intervals while the head moves keep the cursor updates
+ * close to the sample rate; after BLE_CONN_IDLE_DELAY_MS without 
+ * movement a long interval with slave latency saves power. The 
+ * host decides, changes of the negotiated values are logged.
+ *************************************************************/
+void HeadMouse::_updateConnParams(){
+    ConnProfile profile = _conn_profile.update(_status.is_connected, _hid_moves.load(std::memory_order_relaxed), esp_timer_get_time());
+    HmConnParams params = getConnParams();
+
+    if(!_status.is_connected){
+        _conn_params = params;
+        return;
+    }
+
+    if(profile == CONN_PROFILE_ACTIVE){
+        bleMouse.requestConnParams(BLE_CONN_ACTIVE_INTERVAL_MIN, BLE_CONN_ACTIVE_INTERVAL_MAX, BLE_CONN_ACTIVE_LATENCY, BLE_CONN_TIMEOUT);
+    }
+    else if(profile == CONN_PROFILE_IDLE){
+        bleMouse.requestConnParams(BLE_CONN_IDLE_INTERVAL_MIN, BLE_CONN_IDLE_INTERVAL_MAX, BLE_CONN_IDLE_LATENCY, BLE_CONN_TIMEOUT);
+    }
+    if(profile != CONN_PROFILE_NONE){
+        log_message(LOG_INFO, "BLE connection parameters requested: %s", (profile == CONN_PROFILE_ACTIVE) ? "active" : "idle");
+    }
+
+    if((params.interval_us != _conn_params.interval_us) || (params.latency != _conn_params.latency) || 
+       (params.timeout_ms != _conn_params.timeout_ms)){
+        _conn_params = params;
+        log_message(LOG_INFO, "BLE connection interval: %luus, latency: %u, timeout: %lums", (unsigned long)params.interval_us,
+                    params.latency, (unsigned long)params.timeout_ms);
+    }
+}
+
+/************************************************************
+ * @brief Calibration job: IMU calibration state.
+ *
+ * @param arg HeadMouse instance.
+ *************************************************************/
+void HeadMouse::_jobCalibration(void* arg){
+    HeadMouse* hm = (HeadMouse*)arg;
+    CycleTaskTimer task_timer(hm->_cycle_stats, CYCLE_DEV_STATUS);
+    HmStatus old_status = hm->_status;
+
+    hm->_status.is_calibrated = hm->isCalibrated();
+    hm->_triggerLedsOnChange(old_status);
+}
+
+/************************************************************
+ * @brief Battery job: battery voltage and level.
+ *
+ * @param arg HeadMouse instance.
+ *************************************************************/
+void HeadMouse::_jobBattery(void* arg){
+    HeadMouse* hm = (HeadMouse*)arg;
+    CycleTaskTimer task_timer(hm->_cycle_stats, CYCLE_DEV_STATUS);
+    HmStatus old_status = hm->_status;
+
+    hm->updateBatStatus();
+    hm->_triggerLedsOnChange(old_status);
+}
+
+/************************************************************
+ * @brief LED job: show the device status on the status and 
+ *        battery LEDs.
+ *
+ * @param arg HeadMouse instance.
+ *************************************************************/
+void HeadMouse::_jobLeds(void* arg){
+    HeadMouse* hm = (HeadMouse*)arg;
+    CycleTaskTimer task_timer(hm->_cycle_stats, CYCLE_DEV_STATUS);
+
+    log_message(LOG_DEBUG, "Status: \nisCharging: %d\nBatStatus: %d, \nisCalibrated: %d, \nisConnected: %d", 
+    hm->_status.is_charging, hm->_status.bat_status, hm->_status.is_calibrated, hm->_status.is_connected);
+
+    hm->_batStatusInterpreter();
+    hm->_devStatusInterpreter();
+}
+
+/* PUBLIC METHODS */
+/************************************************************
+ * @brief Check if new BNO055 measurement cycle has finished
+ * 
+ * Each timer tick starts one program cycle of the main loop. The 
+ * end of a program cycle is detected by the next call. Not used
+ * while the task pipeline is running.
+ * 
+ * @return TRUE if new data is available, FALSE otherwise.
+ *************************************************************/
+bool HeadMouse::isMeasurementAvailable(){
+    if(_cycle_start_us != 0){
+        _endProgramCycle(_cycle_start_us);
+        _cycle_start_us = 0;
+    }
+    return _startProgramCycle();
+}
+
+/************************************************************
+ * @brief Get program cycle statistics.
+ *
+ * While the task pipeline is running the counters are updated by
+ * several tasks, the copy is not taken atomically.
+ *
+ * @return Program cycle statistics since the last reset.
+ *************************************************************/
+HmCycleStats HeadMouse::getCycleStats(){
+    return _cycle_stats;
+}
+
+/************************************************************
+ * @brief Get job scheduler statistics.
+ *
+ * @param job Job.
+ * @return Statistics of the job since the last reset.
+ *************************************************************/
+HmJobStats HeadMouse::getJobStats(HmJob job){
+    return _scheduler.getStats(job);
+}
+
+/************************************************************
+ * @brief Reset program cycle statistics.
+ *************************************************************/
+void HeadMouse::resetCycleStats(){
+    _cycle_stats = HmCycleStats();
+    _cycle_stats.start_us = esp_timer_get_time();
+    _scheduler.resetStats();
+#ifdef HM_TRACE_TASKS
+    TaskTrace::reset();
+#endif
+}
+
+/************************************************************
+ * @brief Initialize HeadMouse hardware components.
+ *
+ * This function initializes the various hardware components of
+ * the HeadMouse, including pins, BLE communication, and the IMU.
+ * 
+ * @param preferences Struct containing device preferences.
+ * @return ERR_xxx if something went wrong, OK otherwise.
+ *************************************************************/
+err HeadMouse::init(HmPreferences preferences){
+    err error = ERR_GENERIC;
+
+    /* Setup HM preferences */
+    _preferences.mode = preferences.mode;    // Testing only 
+    _preferences.sensititvity = preferences.sensititvity;
+    _preferences.btn_actions[0] = preferences.btn_actions[0];
+    _preferences.btn_actions[1] = preferences.btn_actions[1];
+    _preferences.btn_actions[2] = preferences.btn_actions[2];
+    _preferences.btn_actions[3] = preferences.btn_actions[3];
+    for(uint32_t i=0; i<SENSITIVITY_STEP_COUNT; i++){
+        _preferences.curves[i] = preferences.curves[i];
+    }
+    _preferences.gestures = preferences.gestures;
+    if(!GestureFsm::isMapped(_preferences.gestures) || !GestureFsm::isValid(_preferences.gestures)){
+        _preferences.gestures = GestureFsm::defaultConfig(_preferences.btn_actions);
+    }
+    _gestures.setConfig(_preferences.gestures);
+    //_initPreferences(preferences);
+    _updateMotionCurve();
+    _scroll_curve.build(SCROLL_CURVE);
+    log_message(LOG_INFO, "...Preferences initialized");
+
+    /* Init uC peripherals */
+    if(!SystemTick.begin(TICK_INTERVAL_MS*1000)){
+        log_message(LOG_INFO, "... Cannot init tick timer, aborting..."); 
+        return ERR_GENERIC;
+    }
+    _initPins();
+    log_message(LOG_INFO, "...Pins initialized");
+
+    if(SystemTick.attachChannel(TICK_PROGRAM_CYCLE, PROGRAM_CYCLE_INTERVAL_MS / TICK_INTERVAL_MS, _callbackTimerProgramCycle, true))
+    {    
+        _ticks_handled = _program_cycle_ticks;
+        resetCycleStats();
+        log_message(LOG_INFO, "...Program cycle timer initialized"); 
+    }
+    else{
+        log_message(LOG_INFO, "... Cannot init Program cycle timer, aborting..."); 
+        return ERR_GENERIC;
+    }
+
+    /* Measure the battery before the BLE battery service starts with its level */
+    isCharging();
+    updateBatStatus();
+
+    /* Start ble task manager for bluetooth mouse communication */
+    bleMouse.begin(CORE_BLE);  
+    log_message(LOG_INFO, "...BLE server initialized"); 
+
+    /* Initialise IMU */
+    if(bno.begin()){
+        log_message(LOG_INFO, "...BNO055 initialized");
+    }
+    else{
+        _status.is_error = true;
+        log_message(LOG_ERROR, "...Cannot connect to BNO055");
+        return ERR_CONNECTION_FAILED;
+    }
+
+    /* Data ready interrupt of the BNO055: program cycle trigger with HM_SAMPLING_BNO055_INT, sample age 
+       statistics only with HM_SAMPLE_AGE_STATS, as it costs an I2C write per sample to re-arm */
+#if defined(HM_SAMPLING_BNO055_INT) || defined(HM_SAMPLE_AGE_STATS)
+    _sample_int_enabled = _initSampleInterrupt();
+    if(_sample_int_enabled){
+        log_message(LOG_INFO, "...BNO055 data ready interrupt initialized");
+    }
+    else{
+        log_message(LOG_WARNING, "...Cannot init BNO055 data ready interrupt, sampling with program cycle timer");
+    }
+#endif
+
+    _initJobs();
+    return ERR_NONE;
+}
+
+/************************************************************
+ * @brief Run the due jobs of the program cycle.
+ *
+ * Main loop scheduling (HM_SINGLE_LOOP): call once per program 
+ * cycle after isMeasurementAvailable() returned TRUE. Movements
+ * run every cycle, the device status jobs at their own periods.
+ *************************************************************/
+void HeadMouse::runJobs(){
+    _scheduler.run(_ticks_handled);
+}
+
+/************************************************************
+ * @brief Start the task pipeline.
+ *
+ * Moves the program cycle from the Arduino loop into pinned tasks:
+ * sensor -> motion -> HID, linked by lock-free SPSC queues, and a
+ * housekeeping task for status and LEDs. See def_pipeline.hpp for 
+ * the core layout. isMeasurementAvailable(),
+ * updateDevStatus(), updateMovements() and updateBtnActions() must
+ * not be called afterwards.
+ *
+ * @return ERR_GENERIC if a task could not be created, ERR_NONE 
+ *         otherwise.
+ *************************************************************/
+err HeadMouse::startTasks(){
+    if(!_sensor_signal.init() || !_motion_signal.init() || !_hid_signal.init() || !_housekeeping_signal.init()){
+        log_message(LOG_ERROR, "...Cannot create task signals");
+        return ERR_GENERIC;
+    }
+
+    _ticks_handled = _program_cycle_ticks;
+    _cycle_start_us = 0;
+    _scheduler.setEnabled(JOB_MOTION, false);       // Run by the sensor, motion and HID tasks
+    _scheduler.start(_timer_ticks);
+#ifdef HM_TRACE_TASKS
+    TaskTrace::init();
+#endif
+    if(!taskCreate("hm_sensor", _taskSensor, this, TASK_STACK_SIZE, TASK_PRIO_SENSOR, TASK_CORE_SENSOR) ||
+       !taskCreate("hm_motion", _taskMotion, this, TASK_STACK_SIZE, TASK_PRIO_MOTION, TASK_CORE_MOTION) ||
+       !taskCreate("hm_hid", _taskHid, this, TASK_STACK_SIZE, TASK_PRIO_HID, TASK_CORE_HID) ||
+       !taskCreate("hm_housekeeping", _taskHousekeeping, this, TASK_STACK_SIZE, TASK_PRIO_HOUSEKEEPING, TASK_CORE_HOUSEKEEPING)){
+        log_message(LOG_ERROR, "...Cannot create tasks");
+        return ERR_GENERIC;
+    }
+    _tasks_started = true;
+    _buttons->setEventCallback(_callbackBtnEvent);
+
+    log_message(LOG_INFO, "...Task pipeline started");
+    return ERR_NONE;
+}
+
+
+/************************************************************
+ * @brief Update current device status.
+ *
+ * This function updates the current status of the device,
+ * including battery status, IMU calibration, charging status,
+ * and BLE connection at once, regardless of the job periods.
+ *
+ * @return Device status struct.
+ *************************************************************/
+HmStatus HeadMouse::updateDevStatus(){
+    _jobStatus(this);
+    _jobCalibration(this);
+    _jobBattery(this);
+    _jobLeds(this);
+
+    return _status;
+}
+
+/************************************************************
+ * @brief Update IMU data and translate it into mouse movements.
+ *
+ * This function updates the IMU data and translates the head
+ * movements into mouse cursor movements. Runs the sensor, motion
+ * and HID stage of the task pipeline in a row; the HID report 
+ * also carries the button transitions of updateBtnActions().
+ *
+ * @return ERR_xxx if something went wrong, OK otherwise.
+ *************************************************************/
+err HeadMouse::updateMovements(){
+    ImuSample sample;
+    err error = ERR_CONNECTION_FAILED;
+
+    if(_readSample(&sample)) error = _sendMove(_processSample(sample));
+    _sendHidReport();
+    return error;
+}
+
+/************************************************************
+ * @brief Update button actions.
+ *
+ * This function passes all queued button events in order to the
+ * gesture recognition and performs the actions mapped to the 
+ * recognised gestures. With HM_BTN_LOW_LATENCY buttons only 
+ * mapping left/right to click and long press follow the button 
+ * state instead: pressed on the push, released on release.
+ * Mouse buttons are sent with the next HID report.
+ *************************************************************/
+void HeadMouse::updateBtnActions(){
+    CycleTaskTimer task_timer(_cycle_stats, CYCLE_BTN_ACTIONS);
+    BtnEvent event;
+    GestureOutput gesture;
+    uint32_t dropped = _buttons->getDroppedEvents();
+
+    _cycle_stats.button.dropped += dropped - _btn_dropped_seen;
+    _btn_dropped_seen = dropped;
+
+    while(_buttons->popEvent(&event)){
+        _cycle_stats.button.events++;
+
+#ifdef HM_BTN_LOW_LATENCY
+        /* Forward the debounced button state, the host sees the press at the first edge */
+        int i = event.button;
+        if(_gestures.isPassThrough(i)){
+            btnAction action = (btnAction)_preferences.gestures.actions[i][GESTURE_CLICK];
+            if(event.type == BTN_DOWN){
+                _hid_output.press(action, event.timestamp_us);
+                log_message(LOG_INFO, "Button %d down ",  i);
+            }
+            else if(event.type == BTN_UP){
+                _hid_output.release(action, event.timestamp_us);
+                log_message(LOG_INFO, "Button %d up ",  i);
+            }
+            continue;
+        }
+#endif
+        _gestures.handleEvent(event);
+    }
+
+    /* Timing windows expire without a button event */
+    _gestures.update(esp_timer_get_time());
+    while(_gestures.popGesture(&gesture)){
+        _runGestureAction(gesture);
+    }
+}
+
+/* SETTER */
+
+/************************************************************
+ * @brief Set HeadMouse device preferences.
+ *
+ * This function sets the various preferences for the HeadMouse
+ * device, including mode, sensitivity, pointer acceleration curves,
+ * button actions and button gestures.
+ *
+ * @param preferences Struct containing device preferences.
+ *************************************************************/
+void HeadMouse::setPreferences(HmPreferences preferences){
+    setMode(preferences.mode);
+    for(uint32_t i=0; i<SENSITIVITY_STEP_COUNT; i++){
+        setMotionCurve(i, preferences.curves[i]);
+    }
+    setSensitivity(preferences.sensititvity);
+    setButtonActions(preferences.btn_actions);
+    if(GestureFsm::isMapped(preferences.gestures)) setGestureConfig(preferences.gestures);
+}
+
+/************************************************************
+ * @brief Set HeadMouse motion sensitivity.
+ *
+ * This function sets the sensitivity level for head motion
+ * detection.
+ *
+ * @param sensitivity Sensititvity level for head motion detection.
  *************************************************************/
 void HeadMouse::setSensitivity(devSensitivity sensititvity){
     _preferences.sensititvity = sensititvity;
     nonVolatileMemory.putUInt(STORE_SENSITIVITY, _preferences.sensititvity);
+    _updateMotionCurve();
 
     log_message(LOG_INFO, "Sensitivity set to %d", _preferences.sensititvity);
 }
 
+/************************************************************
+ * @brief Set the pointer acceleration curve of a sensitivity
+ *        level.
+ *
+ * The curve is stored permanently and takes effect immediately
+ * if the level is active.
+ *
+ * @param level Sensitivity level (index of PREF_SENSITIVITY).
+ * @param curve Pointer acceleration curve.
+ * @return ERR_OUT_OF_RANGE if level or curve are invalid, 
+ *         ERR_NONE otherwise.
+ *************************************************************/
+err HeadMouse::setMotionCurve(uint32_t level, const MotionCurve& curve){
+    if((level >= SENSITIVITY_STEP_COUNT) || !MotionCurveTable::isValid(curve)){
+        log_message(LOG_WARNING, "Invalid motion curve for sensitivity level %d", level);
+        return ERR_OUT_OF_RANGE;
+    }
+
+    _preferences.curves[level] = curve;
+    nonVolatileMemory.putBytes(STORE_CURVE[level], &_preferences.curves[level], sizeof(MotionCurve));
+    if(level == _sensitivityLevel()) _updateMotionCurve();
+
+    log_message(LOG_INFO, "Motion curve %d set: %d points", level, curve.point_count);
+    return ERR_NONE;
+}
+
 /************************************************************
  * @brief Set HeadMouse operation mode.
  *
  * This function sets the operation mode of the HeadMouse device.
+ * Entering absolute mode recentres the pointer. Absolute mode 
+ * needs the absolute pointer report (HM_HID_ABSOLUTE), without it 
+ * the movements stay relative.
  *
  * @param mode Device operation mode.
  *************************************************************/
@@ -649,13 +1668,19 @@ void HeadMouse::setMode(devMode mode){
     _preferences.mode = mode;
     nonVolatileMemory.putUInt(STORE_MODE, _preferences.mode);
     log_message(LOG_INFO, "...Mode set to %d", _preferences.mode);
+#ifdef HM_HID_ABSOLUTE
+    if(mode == ABSOLUTE) recenter();
+#else
+    if(mode == ABSOLUTE) log_message(LOG_WARNING, "Absolute mode needs HM_HID_ABSOLUTE, moving relative");
+#endif
 }
 
 /************************************************************
  * @brief Set HeadMouse button pins and corresponding actions.
  *
  * This function sets the microcontroller pins for the buttons and
- * assigns the corresponding actions for each button.
+ * assigns the corresponding actions for each button. The gestures
+ * are reset to run the action on click and long press.
  *
  * @param actions Array of actions associated with each button.
  *************************************************************/
@@ -665,6 +1690,56 @@ void HeadMouse::setButtonActions(btnAction* actions){
         nonVolatileMemory.putUInt(STORE_BTN[i], _preferences.btn_actions[i]);
         log_message(LOG_INFO, "...Set pin %d to action %d", i, _preferences.btn_actions[i]);
     }
+    setGestureConfig(GestureFsm::defaultConfig(_preferences.btn_actions));
+}
+
+/************************************************************
+ * @brief Set the button gesture timing and gesture to action map.
+ *
+ * The config is stored permanently and takes effect immediately,
+ * gestures in progress are discarded.
+ *
+ * @param config Gesture config.
+ * @return ERR_OUT_OF_RANGE if the config is invalid, 
+ *         ERR_NONE otherwise.
+ *************************************************************/
+err HeadMouse::setGestureConfig(const GestureConfig& config){
+    if(!GestureFsm::isValid(config)){
+        log_message(LOG_WARNING, "Invalid gesture config");
+        return ERR_OUT_OF_RANGE;
+    }
+
+    _preferences.gestures = config;
+    nonVolatileMemory.putBytes(STORE_GESTURES, &_preferences.gestures, sizeof(GestureConfig));
+    _gestures.setConfig(_preferences.gestures);
+
+    log_message(LOG_INFO, "Gesture config set: hold %d ms, gap %d ms", config.hold_ms, config.gap_ms);
+    return ERR_NONE;
+}
+
+
+/************************************************************
+ * @brief Recentre the absolute mode.
+ *
+ * The head pose of the next IMU sample points to the screen
+ * centre. No effect in relative mode.
+ *************************************************************/
+void HeadMouse::recenter(){
+    _abs_recenter.store(true);
+}
+
+
+/************************************************************
+ * @brief Switch the scroll mode on or off.
+ *
+ * In scroll mode head rotation moves the wheels instead of the 
+ * pointer.
+ *
+ * @param is_scrolling TRUE to scroll, FALSE to move the pointer.
+ *************************************************************/
+void HeadMouse::setScrolling(bool is_scrolling){
+    _is_scrolling.store(is_scrolling);
+    log_message(LOG_INFO, "Scroll mode %d", is_scrolling);
 }
 
 
@@ -672,21 +1747,32 @@ void HeadMouse::setButtonActions(btnAction* actions){
 
 /************************************************************
  * @brief Read current battery voltage and convert to battery
- *        status.
+ *        status and level.
  *
  * This function reads the current battery voltage and converts it
- * to a corresponding battery status.
+ * to a corresponding battery status. The estimated charge level
+ * is passed to the BLE battery service when it has changed.
  *
  * @return Battery status.
  *************************************************************/
 void HeadMouse::updateBatStatus(){
     BatStatus bat_status_new = BAT_LOW;
 
-    /* Get battery voltage level */
-    int32_t adc_value = analogRead(PIN_VBATT_MEASURE);
-    float_t voltage = 2 * adc_value * 3.3 / 4095; // "2*" because of 50:50 voltage divider
+    /* Get battery voltage level, averaged against ADC noise */
+    uint32_t adc_mv = 0;
+    for(uint32_t i=0; i<BAT_ADC_OVERSAMPLING; i++) adc_mv += analogReadMilliVolts(PIN_VBATT_MEASURE);
+    uint32_t voltage_mv = BAT_DIVIDER * adc_mv / BAT_ADC_OVERSAMPLING;
+    float_t voltage = voltage_mv / 1000.0f;
     log_message(LOG_DEBUG_BAT, "Battery voltage is: %.2fV", voltage);
 
+    /* Pass the charge level to the BLE battery service on percent steps only, each one is a notification */
+    uint8_t bat_level = _bat_gauge.update(voltage_mv, _status.is_charging);
+    if(bat_level != _bat_level_sent){
+        _bat_level_sent = bat_level;
+        bleMouse.setBatteryLevel(bat_level);
+        log_message(LOG_DEBUG_BAT, "Battery level is: %u%%", bat_level);
+    }
+
     /* Determine new battery level status */
     if(!_status.is_charging){ /* Not charging -> bat level decreasing */
         switch(_status.bat_status){ 
@@ -758,6 +1844,16 @@ bool HeadMouse::isCalibrated(){
     else return false;
 }
 
+/************************************************************
+ * @brief Check if scroll mode is active.
+ *
+ * @return TRUE if head rotation moves the wheels, FALSE if it
+ *         moves the pointer.
+ *************************************************************/
+bool HeadMouse::isScrolling(){
+    return _is_scrolling.load();
+}
+
 /************************************************************
  * @brief Check if device is connected to host via Bluetooth.
  *
@@ -773,6 +1869,29 @@ bool HeadMouse::isConnected(){
     else return false;
 }
 
+/************************************************************
+ * @brief Get the negotiated BLE connection parameters.
+ *
+ * @return Connection parameters, interval 0 if not connected.
+ *************************************************************/
+HmConnParams HeadMouse::getConnParams(){
+    HmConnParams params;
+
+    params.interval_us = bleMouse.getConnInterval() * BLE_CONN_INTERVAL_UNIT_US;
+    params.latency = bleMouse.getConnLatency();
+    params.timeout_ms = bleMouse.getConnTimeout() * BLE_CONN_TIMEOUT_UNIT_MS;
+    return params;
+}
+
+/************************************************************
+ * @brief Get the estimated battery charge level.
+ *
+ * @return Battery level [%] of the last updateBatStatus().
+ *************************************************************/
+uint8_t HeadMouse::getBatLevel(){
+    return _bat_gauge.getPercent();
+}
+
 /************************************************************
  * @brief Check if device battery is currently charging.
  *
@@ -1,17 +1,34 @@
 #pragma once
 
+#include <atomic>
 #include "./include/def_general.hpp"
 #include "./include/def_preferences.hpp"
 #include "./include/def_status.hpp"
 #include "./include/hm_board_config_v1_0.hpp"
 #include "./include/led.hpp"
 #include "./include/button.hpp"
+#include "./include/motion_curve.hpp"
+#include "./include/cycle_stats.hpp"
+#include "./include/def_pipeline.hpp"
+#include "./include/spsc_queue.hpp"
+#include "./include/hm_task.hpp"
+#include "./include/task_trace.hpp"
+#include "./include/job_scheduler.hpp"
+#include "./include/gesture.hpp"
+#include "./include/hid_output.hpp"
+#include "./include/absolute_pointer.hpp"
+#include "./include/battery_gauge.hpp"
+#include "./include/conn_profile.hpp"
 #include "Adafruit_Sensor.h"
+#include "utility/imumaths.h"
 
 namespace _headmouse{
-    extern volatile bool _measurement_available;
+    extern volatile uint32_t _program_cycle_ticks;     // Program cycle ticks, incremented by ISRs
+    extern volatile bool _tasks_started;               // Program cycles are run by the task pipeline
 }
 
+constexpr uint32_t MOTION_CURVE_NONE = 2;     // No motion curve buffer in use
+
 class HeadMouse {
     private:
     HmStatus _status;
@@ -19,29 +36,105 @@ class HeadMouse {
     Buttons* _buttons = Buttons::getInstance(PIN_BTN_1, PIN_BTN_2, PIN_BTN_3, PIN_BTN_4);
     Leds* _leds = Leds::getInstance(PIN_LED_BAT_G, PIN_LED_BAT_R, PIN_LED_STATUS_G, PIN_LED_STATUS_R);
     sensors_event_t _imu_data;
+    int32_t _motion_residual_x = 0;   // Fraction of a mouse count carried to the next cycle
+    int32_t _motion_residual_y = 0;
+    int64_t _imu_timestamp_us = 0;    // Time of the previous IMU sample
+    MotionCurveTable _motion_curves[2];               // Pointer acceleration curve of the active sensitivity level,
+    std::atomic<uint32_t> _motion_curve_index{0};     // double buffered as it is rebuilt by the HID task
+    std::atomic<uint32_t> _motion_curve_in_use{MOTION_CURVE_NONE};   // Buffer the motion stage is reading
+    uint32_t _ticks_handled = 0;      // Program cycle timer ticks already handled by the main loop
+    int64_t _cycle_start_us = 0;      // Start of the running program cycle, 0 if none
+    HmCycleStats _cycle_stats;
+    bool _sample_int_enabled = false; // BNO055 data ready interrupt enabled, see init()
+    uint32_t _samples_read = 0;       // Data ready interrupts already handled by a read
+    uint32_t _btn_dropped_seen = 0;   // Dropped button events already added to the cycle statistics
+    uint32_t _hid_dropped_seen = 0;   // Dropped button transitions already added to the cycle statistics
+    std::atomic<uint32_t> _hid_moves{0};  // Movements passed to the HID output, tells the status job that the head moves
+    ConnProfileSelector _conn_profile;   // Connection parameters by head motion, housekeeping only
+    HmConnParams _conn_params;        // Last logged connection parameters
+    SpscQueue<ImuSample, PIPELINE_QUEUE_SIZE> _sample_queue;    // Sensor -> motion task
+    SpscQueue<MouseMove, PIPELINE_QUEUE_SIZE> _move_queue;      // Motion -> HID task
+    GestureFsm _gestures;             // Gesture recognition of the button events
+    HidOutput _hid_output;            // Movements and buttons coalesced into HID reports, HID task only
+    AbsolutePointer _abs_pointer;     // Head pose to screen position of the absolute mode, motion stage only
+    std::atomic<bool> _abs_recenter{false};   // Recentre requested, taken by the motion stage
+    std::atomic<bool> _is_scrolling{false};   // Head rotation moves the wheels instead of the pointer
+    MotionCurveTable _scroll_curve;
+    int32_t _scroll_residual_x = 0;   // Fraction of a wheel count carried to the next cycle, motion stage only
+    int32_t _scroll_residual_y = 0;
+    int32_t _wheel_residual = 0;      // Wheel counts below the host resolution, HID stage only
+    int32_t _pan_residual = 0;
+    BatteryGauge _bat_gauge;          // Battery charge estimation, housekeeping only
+    uint8_t _bat_level_sent = 0;      // Battery level last passed to the BLE battery service [%]
+    JobScheduler _scheduler{PROGRAM_CYCLE_INTERVAL_MS*1000};   // Jobs of HmJob, one tick per program cycle
 
     void _initPins();
     void _initPreferences(HmPreferences);
     void _batStatusInterpreter();
     void _devStatusInterpreter();
+    void _logCycleStats();
+    bool _startProgramCycle();
+    void _endProgramCycle(int64_t);
+    uint32_t _sampleInterval(int64_t);
+    uint32_t _sensitivityLevel();
+    void _updateMotionCurve();
+    bool _readRawQuat(int16_t*);
+    bool _writeBnoRegister(uint8_t, uint8_t);
+    bool _initSampleInterrupt();
+    void _updateSampleStats(uint32_t);
+    void _updateButtonStats(int64_t);
+    void _runGestureAction(const GestureOutput&);
+    void _motionDeltaEuler(imu::Quaternion&, int32_t*, int32_t*);  // Default motion engine
+    void _motionDeltaQuat(imu::Quaternion&, int32_t*, int32_t*);   // Motion engine if HM_MOTION_ENGINE_QUAT defined
+    void _motionDeltaFixed(const int16_t*, int32_t*, int32_t*);    // Motion engine if HM_MOTION_ENGINE_FIXED defined
+    bool _readSample(ImuSample*);                   // Sensor stage
+    MouseMove _processSample(const ImuSample&);     // Motion stage
+    err _sendMove(const MouseMove&);                // HID stage
+    void _sendHidReport();
+    static void _taskSensor(void*);
+    static void _taskMotion(void*);
+    static void _taskHid(void*);
+    static void _taskHousekeeping(void*);
+    void _triggerLedsOnChange(const HmStatus&);
+    void _updateConnParams();
+    void _initJobs();
+    static void _jobMotion(void*);
+    static void _jobStatus(void*);
+    static void _jobCalibration(void*);
+    static void _jobBattery(void*);
+    static void _jobLeds(void*);
     static bool _callbackTimerProgramCycle(void *);
+    static void _callbackSampleReady();
+    static void _callbackBtnEvent();
    
     public:
     HeadMouse(){}
     bool isMeasurementAvailable();
+    HmCycleStats getCycleStats();
+    void resetCycleStats();
+    HmJobStats getJobStats(HmJob);
 
     err init(HmPreferences);
+    err startTasks();
+    void runJobs();
     HmStatus updateDevStatus();
     err updateMovements();
     void updateBtnActions();
 
     void setPreferences(HmPreferences);
     void setSensitivity(devSensitivity);
+    err setMotionCurve(uint32_t, const MotionCurve&);
     void setMode(devMode);
     void setButtonActions(btnAction*);
+    err setGestureConfig(const GestureConfig&);
+    void recenter();
+    void setScrolling(bool);
 
     void updateBatStatus();
+    uint8_t getBatLevel();
     bool isCalibrated();
+    bool isScrolling();
     bool isConnected();
+    HmConnParams getConnParams();
     bool isCharging();
 };
\ No newline at end of file
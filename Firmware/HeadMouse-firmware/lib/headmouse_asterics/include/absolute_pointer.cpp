@@ -0,0 +1,109 @@
+#include <math.h>
+#include "absolute_pointer.hpp"
+
+static constexpr float QUAT_LSB = 1.0f / (1 << 14);                 // BNO055 quaternion unit per LSB
+static constexpr float DEADBAND = ABS_DEADBAND_URAD / 1000000.0f;   // [RAD]
+
+/* Move a filtered angle only if the new one leaves the deadband around it */
+static inline float _deadband(float filtered, float angle){
+    if(angle > filtered + DEADBAND) return angle - DEADBAND;
+    if(angle < filtered - DEADBAND) return angle + DEADBAND;
+    return filtered;
+}
+
+/* Screen position of a rotation, the range spans 0..ABS_POSITION_MAX */
+static inline int32_t _toPosition(float angle, float range){
+    float position = (0.5f + angle / range) * ABS_POSITION_MAX;
+    if(position < 0.0f) return 0;
+    if(position > ABS_POSITION_MAX) return ABS_POSITION_MAX;
+    return (int32_t)(position + 0.5f);
+}
+
+/************************************************************
+ * @brief Set the head rotation spanning the whole screen.
+ *
+ * @param range_x_mrad Rotation from the left to the right edge [mRAD].
+ * @param range_y_mrad Rotation from the top to the bottom edge [mRAD].
+ *************************************************************/
+void AbsolutePointer::setRange(uint16_t range_x_mrad, uint16_t range_y_mrad){
+    if((range_x_mrad == 0) || (range_y_mrad == 0)) return;
+
+    _range_x = range_x_mrad / 1000.0f;
+    _range_y = range_y_mrad / 1000.0f;
+}
+
+/************************************************************
+ * @brief Make a head pose the centre pose.
+ *
+ * @param quat Orientation quaternion w, x, y, z (1 LSB = 2^-14).
+ *************************************************************/
+void AbsolutePointer::recenter(const int16_t* quat){
+    float w = QUAT_LSB*quat[0];
+    float x = QUAT_LSB*quat[1];
+    float y = QUAT_LSB*quat[2];
+    float z = QUAT_LSB*quat[3];
+    float norm = sqrtf(w*w + x*x + y*y + z*z);
+
+    if(norm < 0.5f) return;     // No valid orientation yet
+    _center[0] = w / norm;
+    _center[1] = x / norm;
+    _center[2] = y / norm;
+    _center[3] = z / norm;
+    _angle_x = 0.0f;
+    _angle_y = 0.0f;
+    _is_centered = true;
+}
+
+/************************************************************
+ * @brief Drop the centre pose, the next mapped pose becomes the
+ *        new one.
+ *************************************************************/
+void AbsolutePointer::reset(){
+    _is_centered = false;
+}
+
+bool AbsolutePointer::isCentered(){
+    return _is_centered;
+}
+
+/************************************************************
+ * @brief Map a head pose to a screen position.
+ *
+ * Without a centre pose, the pose is made the centre pose first.
+ * Uses the rotation vector of centre^-1 * pose in the sensor
+ * frame with the sign convention of the relative motion engines:
+ * X = -rotation about z, Y = +rotation about x.
+ *
+ * @param quat Orientation quaternion w, x, y, z (1 LSB = 2^-14).
+ * @param x Output: horizontal position 0..ABS_POSITION_MAX.
+ * @param y Output: vertical position 0..ABS_POSITION_MAX.
+ *************************************************************/
+void AbsolutePointer::map(const int16_t* quat, int32_t* x, int32_t* y){
+    if(!_is_centered) recenter(quat);
+
+    float w = QUAT_LSB*quat[0];
+    float qx = QUAT_LSB*quat[1];
+    float qy = QUAT_LSB*quat[2];
+    float qz = QUAT_LSB*quat[3];
+    const float* c = _center;
+
+    /* Relative rotation q_rel = conj(centre) * pose */
+    float rel_w = c[0]*w + c[1]*qx + c[2]*qy + c[3]*qz;
+    float rel_x = c[0]*qx - c[1]*w - c[2]*qz + c[3]*qy;
+    float rel_y = c[0]*qy + c[1]*qz - c[2]*w - c[3]*qx;
+    float rel_z = c[0]*qz - c[1]*qy + c[2]*qx - c[3]*w;
+
+    /* Take shortest path, q and -q describe the same orientation */
+    if(rel_w < 0){
+        rel_w = -rel_w; rel_x = -rel_x; rel_y = -rel_y; rel_z = -rel_z;
+    }
+
+    /* Rotation vector = axis * angle, 2 * vector part for small angles */
+    float sin_half = sqrtf(rel_x*rel_x + rel_y*rel_y + rel_z*rel_z);
+    float scale = (sin_half > 1e-6f) ? 2.0f*atan2f(sin_half, rel_w) / sin_half : 2.0f;
+
+    _angle_x = _deadband(_angle_x, -scale*rel_z);
+    _angle_y = _deadband(_angle_y, scale*rel_x);
+    *x = _toPosition(_angle_x, _range_x);
+    *y = _toPosition(_angle_y, _range_y);
+}
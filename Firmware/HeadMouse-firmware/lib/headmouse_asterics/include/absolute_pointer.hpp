@@ -0,0 +1,30 @@
+#pragma once
+
+#include "def_preferences.hpp"
+
+/*! *********************************************************
+* @brief Mapping of the head pose to an absolute screen position.
+*
+* The position follows the head rotation from a centre pose: 
+* ABS_RANGE_X/Y_MRAD span the whole screen, the centre pose points
+* to the screen centre. The rotation is taken from the relative
+* quaternion centre^-1 * pose, so it has no Euler wraparound and
+* no drift. A small deadband keeps the pointer still against 
+* sensor noise.
+*************************************************************/
+class AbsolutePointer {
+    private:
+    float _center[4] = {1.0f, 0.0f, 0.0f, 0.0f};    // Centre pose w, x, y, z
+    bool _is_centered = false;
+    float _angle_x = 0.0f;          // Deadband filtered rotation from the centre pose [RAD]
+    float _angle_y = 0.0f;
+    float _range_x = ABS_RANGE_X_MRAD[0] / 1000.0f;     // [RAD]
+    float _range_y = ABS_RANGE_Y_MRAD[0] / 1000.0f;
+
+    public:
+    void setRange(uint16_t range_x_mrad, uint16_t range_y_mrad);
+    void recenter(const int16_t* quat);
+    void reset();
+    bool isCentered();
+    void map(const int16_t* quat, int32_t* x, int32_t* y);
+};
@@ -0,0 +1,82 @@
+#include "battery_gauge.hpp"
+
+/************************************************************
+ * @brief Get the remaining charge of a cell voltage.
+ *
+ * Interpolates linearly between the points of BAT_CURVE.
+ *
+ * @param voltage_mv Open circuit cell voltage [mV].
+ * @return Remaining charge [%].
+ *************************************************************/
+uint8_t BatteryGauge::percentOf(uint32_t voltage_mv){
+    if(voltage_mv >= BAT_CURVE[0].voltage_mv) return BAT_CURVE[0].percent;
+
+    for(uint32_t i=1; i<BAT_CURVE_POINT_COUNT; i++){
+        const BatCurvePoint& high = BAT_CURVE[i-1];
+        const BatCurvePoint& low = BAT_CURVE[i];
+        if(voltage_mv >= low.voltage_mv){
+            uint32_t span_mv = high.voltage_mv - low.voltage_mv;
+            uint32_t span_percent = high.percent - low.percent;
+            return low.percent + ((voltage_mv - low.voltage_mv) * span_percent + span_mv / 2) / span_mv;
+        }
+    }
+    return BAT_CURVE[BAT_CURVE_POINT_COUNT - 1].percent;
+}
+
+/************************************************************
+ * @brief Add a battery voltage measurement.
+ *
+ * The first measurement and the first one after the charging
+ * state has changed set the estimate directly, later ones can
+ * only lower it while discharging and raise it while charging.
+ *
+ * @param voltage_mv Measured battery voltage [mV].
+ * @param is_charging TRUE if the charger is active.
+ * @return Remaining charge [%].
+ *************************************************************/
+uint8_t BatteryGauge::update(uint32_t voltage_mv, bool is_charging){
+    bool is_first = (_filtered_mv == 0) || (is_charging != _is_charging);
+    uint8_t percent;
+
+    if(is_charging){
+        voltage_mv = (voltage_mv > BAT_CHARGE_OFFSET_MV) ? voltage_mv - BAT_CHARGE_OFFSET_MV : 0;
+    }
+
+    if(_filtered_mv == 0) _filtered_mv = voltage_mv << BAT_FILTER_SHIFT;
+    else _filtered_mv += voltage_mv - (_filtered_mv >> BAT_FILTER_SHIFT);
+    _is_charging = is_charging;
+
+    percent = percentOf(getVoltage());
+    if(is_first || (is_charging && (percent > _percent)) || (!is_charging && (percent < _percent))){
+        _percent = percent;
+    }
+    return _percent;
+}
+
+/************************************************************
+ * @brief Discard the measurements, the next one sets the
+ *        estimate directly.
+ *************************************************************/
+void BatteryGauge::reset(){
+    _filtered_mv = 0;
+    _percent = 0;
+    _is_charging = false;
+}
+
+/************************************************************
+ * @brief Get the filtered cell voltage.
+ *
+ * @return Cell voltage without the charging offset [mV].
+ *************************************************************/
+uint32_t BatteryGauge::getVoltage(){
+    return (_filtered_mv + (1 << (BAT_FILTER_SHIFT - 1))) >> BAT_FILTER_SHIFT;
+}
+
+/************************************************************
+ * @brief Get the remaining charge.
+ *
+ * @return Remaining charge [%].
+ *************************************************************/
+uint8_t BatteryGauge::getPercent(){
+    return _percent;
+}
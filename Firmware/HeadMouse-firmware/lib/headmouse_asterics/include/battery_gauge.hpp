@@ -0,0 +1,27 @@
+#pragma once
+
+#include "def_status.hpp"
+
+/*! *********************************************************
+* @brief Battery charge estimation from the cell voltage.
+*
+* The measured voltage is low pass filtered and looked up in the
+* LiPo discharge curve BAT_CURVE. While charging, the charge
+* current raises the cell voltage by about BAT_CHARGE_OFFSET_MV,
+* which is subtracted before the lookup. The estimate only falls
+* while discharging and only rises while charging, so ADC noise
+* and load steps cannot make it flicker around a percent step.
+*************************************************************/
+class BatteryGauge {
+    private:
+    uint32_t _filtered_mv = 0;      // Compensated cell voltage [mV]*2^BAT_FILTER_SHIFT, 0 before the first measurement
+    uint8_t _percent = 0;
+    bool _is_charging = false;
+
+    public:
+    static uint8_t percentOf(uint32_t voltage_mv);
+    uint8_t update(uint32_t voltage_mv, bool is_charging);
+    void reset();
+    uint32_t getVoltage();
+    uint8_t getPercent();
+};
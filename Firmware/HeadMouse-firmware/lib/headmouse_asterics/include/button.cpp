@@ -1,17 +1,14 @@
 #include <Arduino.h>
+#include "esp_timer.h"
 #include "button.hpp"
 #include "logging.hpp"
 #include "def_general.hpp"
 #include "hw_isr.hpp"
 
-static constexpr uint32_t BTN_DEBOUNCE_MS = 25;    // Debounce time until button push is valid
-static constexpr uint32_t BTN_TIMEOUT_COUNT = 250000/BTN_DEBOUNCE_MS;  // Timeout count for max button press duration to prevent overflow
-static constexpr uint32_t BTN_CLICK_MAX_COUNT = 200/BTN_DEBOUNCE_MS; // Count for maximum click time of button (longer button push is rated as press)
+static constexpr uint32_t BTN_DEBOUNCE_MS = 20;        // Lockout after an accepted edge, shorter pushes are no click
+static constexpr uint32_t BTN_CLICK_MAX_MS = 200;       // Maximum click time of button (longer button push is rated as press)
+static constexpr uint32_t BTN_TIMEOUT_MS = 250000;      // Max button press duration, a stuck button ends its press
 
-
-namespace isr{
-    ESP32Timer BtnTimer(0);
-}
 using namespace isr;
 
 
@@ -42,7 +39,8 @@ Buttons* Buttons::getInstance(pin pin_btn_0, pin pin_btn_1, pin pin_btn_2, pin p
  * @brief Initialize the button pins.
  *
  * This function sets up the button pins as input with pull-up
- * resistors and attaches a timer interrupt for debouncing.
+ * resistors and attaches the button channel of the tick timer,
+ * which runs every tick for press timing and lockout expiry.
  *
  * @return ERR_NONE if initialization is successful, otherwise
  * ERR_GENERIC.
@@ -54,8 +52,7 @@ err Buttons::initPins(){
         log_message(LOG_DEBUG, "Pin %d initialized as input with pullup", i);
     }
 
-    if (BtnTimer.attachInterruptInterval(BTN_DEBOUNCE_MS * 1000, callbackTimerBtn)){
-        BtnTimer.stopTimer();
+    if (SystemTick.attachChannel(TICK_BUTTONS, 1, callbackTimerBtn, true)){
         error = ERR_NONE;
     }
     else error = ERR_GENERIC;
@@ -67,20 +64,23 @@ err Buttons::initPins(){
 /************************************************************
  * @brief Enable button interrupts.
  *
- * This function resets the button activity states and attaches
- * interrupts to the button pins to detect button presses.
+ * This function resets the button states and attaches interrupts 
+ * to both edges of the button pins.
  *************************************************************/
 void Buttons::enableButtonInterrupts() {
     /* Reset button activity first */
     for(int i=0; i<BUTTON_COUNT; i++){
         is_active[i] = false;
+        _is_down[i] = false;
+        _is_press[i] = false;
+        _pending_us[i] = 0;
     }
 
     /* Then start pin change interrupts */
-    attachInterrupt(digitalPinToInterrupt(_pins[0]), callbackBtnPress0, FALLING);
-    attachInterrupt(digitalPinToInterrupt(_pins[1]), callbackBtnPress1, FALLING);
-    attachInterrupt(digitalPinToInterrupt(_pins[2]), callbackBtnPress2, FALLING);
-    attachInterrupt(digitalPinToInterrupt(_pins[3]), callbackBtnPress3, FALLING);
+    attachInterrupt(digitalPinToInterrupt(_pins[0]), callbackBtnPress0, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(_pins[1]), callbackBtnPress1, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(_pins[2]), callbackBtnPress2, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(_pins[3]), callbackBtnPress3, CHANGE);
    
 }
 
@@ -98,53 +98,177 @@ void Buttons::disableButtonInterrupts() {
 
 
 /************************************************************
- * @brief Handle a button press event.
+ * @brief Handle a button edge.
  *
- * This function handles a button press event by disabling further
- * button interrupts and setting the button as active. It also
- * restarts the debounce timer.
+ * This function accepts the edge if the button is not in its 
+ * debounce lockout and the pin level confirms a state change.
+ * Otherwise the edge time is kept for the lockout expiry. The
+ * cost is constant and independent of the other buttons.
  *
- * @param index The index of the button that was pressed.
+ * @param index The index of the button.
  *************************************************************/
-void Buttons::_handleBtnPress(int index) {
-    disableButtonInterrupts();  /* Prevent multiple button actions to be detected */
+void IRAM_ATTR Buttons::_handleBtnEdge(int index) {
+    int64_t now_us = esp_timer_get_time();
+    bool is_down = !digitalRead(_pins[index]);
+
+    if (((now_us - _lock_us[index]) < (int64_t)BTN_DEBOUNCE_MS*1000) || (is_down == _is_down[index])) {
+        _pending_us[index] = now_us;    /* Bouncing, level is checked when the lockout expires */
+        is_active[index] = true;
+        return;
+    }
+    _acceptEdge(index, is_down, now_us, now_us);
+}
+
+/************************************************************
+ * @brief Accept a button state change and queue its events.
+ *
+ * @param index The index of the button.
+ * @param is_down New button state.
+ * @param edge_us Time of the edge [us].
+ * @param now_us Current time, start of the lockout [us].
+ *************************************************************/
+void IRAM_ATTR Buttons::_acceptEdge(int index, bool is_down, int64_t edge_us, int64_t now_us) {
+    _is_down[index] = is_down;
+    _lock_us[index] = now_us;
+    _pending_us[index] = 0;
     is_active[index] = true;
-    BtnTimer.restartTimer();    /* Start debounce mechanism */
+
+    if (is_down) {
+        _down_us[index] = edge_us;
+        _pushEvent(index, BTN_DOWN, edge_us);
+        return;
+    }
+
+    int64_t duration_us = edge_us - _down_us[index];
+    _pushEvent(index, BTN_UP, edge_us);
+    if (_is_press[index]) { /* Complete button press */
+        _is_press[index] = false;
+        _pushEvent(index, BTN_PRESS_END, edge_us);
+    } /* Pushes shorter than the lockout are invalid */
+    else if ((duration_us >= (int64_t)BTN_DEBOUNCE_MS*1000) && (duration_us < (int64_t)BTN_CLICK_MAX_MS*1000)) {
+        _pushEvent(index, BTN_CLICK, edge_us);
+    }
+}
+
+/************************************************************
+ * @brief Tick update of an active button.
+ *
+ * This function picks up a level change hidden in the expired 
+ * lockout and detects long presses and their timeout.
+ *
+ * @param index The index of the button.
+ * @param now_us Time of the tick [us].
+ *************************************************************/
+void IRAM_ATTR Buttons::_updateBtn(int index, int64_t now_us) {
+    if ((now_us - _lock_us[index]) < (int64_t)BTN_DEBOUNCE_MS*1000) return;
+
+    bool is_down = !digitalRead(_pins[index]);
+    if (is_down != _is_down[index]) {
+        _acceptEdge(index, is_down, (_pending_us[index] != 0) ? _pending_us[index] : now_us, now_us);
+        return;
+    }
+    _pending_us[index] = 0;
+
+    if (!is_down) {
+        is_active[index] = false;
+        return;
+    }
+
+    /* Button still pressed */
+    int64_t hold_us = now_us - _down_us[index];
+    if (!_is_press[index] && (hold_us >= (int64_t)BTN_CLICK_MAX_MS*1000) && (hold_us < (int64_t)BTN_TIMEOUT_MS*1000)) {
+        _is_press[index] = true;    /* Detect button press if it has been pressed for at least 200ms */
+        _pushEvent(index, BTN_PRESS_START, now_us);
+    }
+    else if (_is_press[index] && (hold_us >= (int64_t)BTN_TIMEOUT_MS*1000)) {  /* Timeout of a stuck button */
+        _is_press[index] = false;
+        _pushEvent(index, BTN_PRESS_END, now_us);
+    }
+}
+
+/************************************************************
+ * @brief Queue a button event (ISR context).
+ *
+ * @param index The index of the button.
+ * @param type Event type.
+ * @param timestamp_us Time of the event [us].
+ *************************************************************/
+void IRAM_ATTR Buttons::_pushEvent(int index, BtnEventType type, int64_t timestamp_us) {
+    BtnEvent event = {timestamp_us, (uint8_t)index, type};
+
+    if (!_events.push(event)) {
+        _dropped_events++;
+    }
+    else if (_event_callback != nullptr) {
+        _event_callback();
+    }
+}
+
+/************************************************************
+ * @brief Get the oldest button event.
+ *
+ * Must only be called by one task, the one running the button 
+ * actions.
+ *
+ * @param event Output: oldest button event.
+ * @return TRUE if an event was available, FALSE otherwise.
+ *************************************************************/
+bool Buttons::popEvent(BtnEvent* event) {
+    return _events.pop(event);
+}
+
+/************************************************************
+ * @brief Set a function called (in ISR context) whenever an event
+ *        has been queued, e.g. to wake the consumer task.
+ *
+ * @param callback Event callback, nullptr to remove it.
+ *************************************************************/
+void Buttons::setEventCallback(BtnEventCallback callback) {
+    _event_callback = callback;
+}
+
+/************************************************************
+ * @brief Get the number of events lost on a full queue.
+ *
+ * @return Dropped events since startup.
+ *************************************************************/
+uint32_t Buttons::getDroppedEvents() {
+    return _dropped_events;
 }
 
 /************************************************************
  * @brief Callback function for button-0 press interrupt.
  *
- * This function is called when the button is pressed and
- * handles the button press event.
+ * This function is called on every edge of the button and
+ * handles the button edge.
  *************************************************************/
 void IRAM_ATTR Buttons::callbackBtnPress0() {
     if (instance) {
-        instance->_handleBtnPress(0);
+        instance->_handleBtnEdge(0);
     }
 }
 
 /************************************************************
  * @brief Callback function for button-1 press interrupt.
  *
- * This function is called when the button is pressed and
- * handles the button press event.
+ * This function is called on every edge of the button and
+ * handles the button edge.
  *************************************************************/
 void IRAM_ATTR Buttons::callbackBtnPress1() {
     if (instance) {
-        instance->_handleBtnPress(1);
+        instance->_handleBtnEdge(1);
     }
 }
 
 /************************************************************
  * @brief Callback function for button-2 press interrupt.
  *
- * This function is called when the button is pressed and
- * handles the button press event.
+ * This function is called on every edge of the button and
+ * handles the button edge.
  *************************************************************/
 void IRAM_ATTR Buttons::callbackBtnPress2() {
     if (instance) {
-        instance->_handleBtnPress(2);
+        instance->_handleBtnEdge(2);
     }
 }
 
@@ -152,63 +276,31 @@ void IRAM_ATTR Buttons::callbackBtnPress2() {
 /************************************************************
  * @brief Callback function for the button-3 press interrupt.
  *
- * This function is called when the button is pressed and
- * handles the button press event.
+ * This function is called on every edge of the button and
+ * handles the button edge.
  *************************************************************/
 void IRAM_ATTR Buttons::callbackBtnPress3() {
     if (instance) {
-        instance->_handleBtnPress(3);
+        instance->_handleBtnEdge(3);
     }
 }
 
 /************************************************************
  * @brief Timer callback function for button debounce handling.
  *
- * This function is called by the timer interrupt to handle
- * debouncing of the button presses. It detects if a button is still
- * pressed and handles click and press events accordingly.
+ * This function is called by the tick timer interrupt on every 
+ * tick and updates the active buttons.
  *
- * @param timerNo The timer number (unused).
+ * @param channel The tick timer channel (unused).
  * @return Always returns true.
  *************************************************************/
-bool IRAM_ATTR Buttons::callbackTimerBtn(void* timerNo) {
-    int index = 0;
+bool IRAM_ATTR Buttons::callbackTimerBtn(void* channel) {
+    (void)channel;
+    if (instance == nullptr) return true;
 
-    /* Detect which button is active */
+    int64_t now_us = esp_timer_get_time();
     for (int i = 0; i < BUTTON_COUNT; i++) {
-        if (instance->is_active[i]) {
-            index = i;
-            break;
-        }
-    }
-
-    /* Button still pressed? */
-    if (!digitalRead(instance->_pins[index])) {
-        instance->_count++;
-        if ((instance->_count >= BTN_CLICK_MAX_COUNT) && (!instance->is_press[index])) {
-            instance->is_press[index] = true;  /* Detect button press if it has been pressed for at least 500ms */
-        }
-        if (instance->_count >= BTN_TIMEOUT_COUNT) { /* Timeout to prevent overflow */
-            instance->_count = 0;
-            instance->is_press[index] = false;
-            BtnTimer.stopTimer();
-            instance->enableButtonInterrupts();
-        }
-    } /* Button not pressed any more */
-    else if (instance->_count == 0) {
-        /* Ignore this case, invalid click/press duration */
-        BtnTimer.stopTimer();
-        instance->enableButtonInterrupts();
-    } else if (instance->_count < BTN_CLICK_MAX_COUNT) { /* Only detect click if 25-500ms have passed since button release */
-        instance->is_click[index] = true;
-        instance->_count = 0;
-        BtnTimer.stopTimer();
-        instance->enableButtonInterrupts();
-    } else { /* Complete button press */
-        instance->is_press[index] = false;
-        instance->_count = 0;
-        BtnTimer.stopTimer();
-        instance->enableButtonInterrupts();
+        if (instance->is_active[i]) instance->_updateBtn(i, now_us);
     }
 
     return true;
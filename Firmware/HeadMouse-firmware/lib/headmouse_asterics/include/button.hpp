@@ -2,16 +2,58 @@
 
 #include "def_general.hpp"
 #include "def_preferences.hpp"
+#include "spsc_queue.hpp"
 
 static constexpr uint8_t BUTTON_COUNT = 4;
+static constexpr uint32_t BTN_EVENT_QUEUE_SIZE = 16;   // Button events buffered between ISRs and button actions
+
+/*! *********************************************************
+* @brief Enum to define the button events
+*************************************************************/
+enum BtnEventType {
+    BTN_DOWN,           // Push, timestamp of the falling edge
+    BTN_UP,             // Release, timestamp of the rising edge
+    BTN_CLICK,          // Released within the click time
+    BTN_PRESS_START,    // Held longer than the click time
+    BTN_PRESS_END       // Long press released (or timed out)
+};
+
+/*! *********************************************************
+* @brief Button event passed from the button ISRs to the button
+*        actions.
+* @param timestamp_us Time of the pin edge (down, up, click, press
+*        end) or of the tick (press start, timeout) [us].
+* @param button Button index.
+* @param type Event type.
+*************************************************************/
+struct BtnEvent {
+    int64_t timestamp_us;
+    uint8_t button;
+    BtnEventType type;
+};
+
+typedef void (*BtnEventCallback)();
 
 /*! *********************************************************
 * @brief Class to handle interrupt based buttons
+*
+* Edges are debounced by a lockout: the first edge which changes
+* the pin level is accepted at once with its timestamp, further
+* edges are ignored for BTN_DEBOUNCE_MS. A level change hidden in
+* the lockout is picked up by the tick timer once it expired.
 *************************************************************/
 class Buttons {
 private: 
     const pin _pins[BUTTON_COUNT]; // Array of uC pins which buttons are attached to
-    uint32_t _count = 0;    // Internal counter for passed time since button was pushed
+    bool _is_down[BUTTON_COUNT] = {false};      // Debounced button state
+    bool _is_press[BUTTON_COUNT] = {false};     // TRUE while a long press of the button is reported
+    int64_t _down_us[BUTTON_COUNT] = {0};       // Time of the accepted falling edge [us]
+    int64_t _lock_us[BUTTON_COUNT] = {0};       // Start of the debounce lockout [us]
+    int64_t _pending_us[BUTTON_COUNT] = {0};    // Last edge ignored by the debounce, 0 if none [us]
+    BtnEventCallback _event_callback = nullptr;
+    SpscQueue<BtnEvent, BTN_EVENT_QUEUE_SIZE> _events;  // Producer: pin and tick timer ISRs (same core, 
+                                                        // same interrupt level), consumer: button actions
+    volatile uint32_t _dropped_events = 0;
 
     static Buttons* instance; // Static instance pointer for singleton
 
@@ -23,15 +65,16 @@ private:
     static void IRAM_ATTR callbackBtnPress2();
     static void IRAM_ATTR callbackBtnPress3();
 
-    static bool IRAM_ATTR callbackTimerBtn(void* timerNo);
+    static bool IRAM_ATTR callbackTimerBtn(void* channel);
 
-    void _handleBtnPress(int index);
+    void _handleBtnEdge(int index);
+    void _acceptEdge(int index, bool is_down, int64_t edge_us, int64_t now_us);
+    void _updateBtn(int index, int64_t now_us);
+    void _pushEvent(int index, BtnEventType type, int64_t timestamp_us);
 
 public:
-    bool is_active[BUTTON_COUNT] = {false};     // TRUE if button is currently active (resulting action 
-                                                // (click/press/invalid) has not been detected yet)
-    bool is_click[BUTTON_COUNT] = {false};      // TRUE if button click recently detected
-    bool is_press[BUTTON_COUNT] = {false};      // TRUE if button press recently detected
+    bool is_active[BUTTON_COUNT] = {false};     // TRUE if button is currently active (pushed or in the 
+                                                // debounce lockout)
 
     // Static method to get the singleton instance
     static Buttons* getInstance(pin pin0, pin pin1, pin pin2, pin pin3);
@@ -39,4 +82,7 @@ public:
     void enableButtonInterrupts();
     void disableButtonInterrupts();
     err initPins();
+    bool popEvent(BtnEvent* event);
+    void setEventCallback(BtnEventCallback callback);
+    uint32_t getDroppedEvents();
 };
\ No newline at end of file
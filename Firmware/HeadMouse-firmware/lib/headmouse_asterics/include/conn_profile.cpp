@@ -0,0 +1,37 @@
+#include "conn_profile.hpp"
+
+/************************************************************
+ * @brief Check the head motion and select the profile.
+ *
+ * @param is_connected TRUE if a host is connected.
+ * @param moves Movement counter, any change is a movement.
+ * @param now_us Current time [us].
+ * @return Profile to request now, CONN_PROFILE_NONE if it has not
+ *         changed or no host is connected.
+ *************************************************************/
+ConnProfile ConnProfileSelector::update(bool is_connected, uint32_t moves, int64_t now_us){
+    ConnProfile profile = CONN_PROFILE_IDLE;
+
+    if(!is_connected){
+        _profile = CONN_PROFILE_NONE;
+        return CONN_PROFILE_NONE;
+    }
+
+    /* Start active after connecting, the user is about to move */
+    if((moves != _moves_seen) || (_profile == CONN_PROFILE_NONE)) _motion_seen_us = now_us;
+    _moves_seen = moves;
+    if((now_us - _motion_seen_us) < (int64_t)BLE_CONN_IDLE_DELAY_MS*1000) profile = CONN_PROFILE_ACTIVE;
+
+    if(profile == _profile) return CONN_PROFILE_NONE;
+    _profile = profile;
+    return profile;
+}
+
+/************************************************************
+ * @brief Get the last requested profile.
+ *
+ * @return Profile, CONN_PROFILE_NONE if not connected.
+ *************************************************************/
+ConnProfile ConnProfileSelector::getProfile(){
+    return _profile;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "def_preferences.hpp"
+#include "def_status.hpp"
+
+/*! *********************************************************
+* @brief Choice of the BLE connection parameters by head motion.
+*
+* The active profile is requested on connecting and whenever a
+* movement is seen, the idle profile once no movement was seen for
+* BLE_CONN_IDLE_DELAY_MS. Each profile is requested once per
+* change, the host decides on the parameters.
+*************************************************************/
+class ConnProfileSelector {
+    private:
+    ConnProfile _profile = CONN_PROFILE_NONE;   // Last requested profile
+    uint32_t _moves_seen = 0;
+    int64_t _motion_seen_us = 0;    // Time of the last movement seen
+
+    public:
+    ConnProfile update(bool is_connected, uint32_t moves, int64_t now_us);
+    ConnProfile getProfile();
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_timer.h"
+
+constexpr uint32_t CYCLE_STATS_LOG_INTERVAL = 1000;  // Program cycles between cycle statistic logs
+constexpr uint32_t SAMPLE_AGE_BUCKET_US = 1000;       // Width of a sample age histogram bucket
+constexpr uint32_t SAMPLE_AGE_BUCKET_COUNT = 12;      // Last bucket collects all older samples
+
+/*! *********************************************************
+* @brief Enum to define the tasks of a program cycle, the 
+*        movement is split into sensor, motion and HID stage
+*************************************************************/
+enum CycleTask {
+    CYCLE_DEV_STATUS,
+    CYCLE_SENSOR,
+    CYCLE_MOTION,
+    CYCLE_HID,
+    CYCLE_BTN_ACTIONS,
+    CYCLE_TASK_COUNT
+};
+
+/*! *********************************************************
+* @brief Struct to store IMU sample statistics, based on the
+*        BNO055 data ready interrupt.
+* @param samples Number of fusion samples read.
+* @param duplicates Reads without new fusion sample.
+* @param skipped Fusion samples never read.
+* @param age_max_us Worst-case age of a sample when read [us].
+* @param age_sum_us Sum of the sample ages [us].
+* @param age_histogram Sample ages in SAMPLE_AGE_BUCKET_US steps.
+*************************************************************/
+struct HmSampleStats {
+    uint32_t samples = 0;
+    uint32_t duplicates = 0;
+    uint32_t skipped = 0;
+    uint32_t age_max_us = 0;
+    uint64_t age_sum_us = 0;
+    uint32_t age_histogram[SAMPLE_AGE_BUCKET_COUNT] = {0};
+};
+
+/*! *********************************************************
+* @brief Struct to store button statistics.
+* @param events Number of button events handled.
+* @param dropped Button events lost on a full event queue.
+* @param reports Button transitions sent as HID report.
+* @param latency_max_us Worst-case time from the ISR detecting a
+*        button event to its HID report [us].
+* @param latency_sum_us Sum of the button-to-HID latencies [us].
+*************************************************************/
+struct HmButtonStats {
+    uint32_t events = 0;
+    uint32_t dropped = 0;
+    uint32_t reports = 0;
+    uint32_t latency_max_us = 0;
+    uint64_t latency_sum_us = 0;
+};
+
+/*! *********************************************************
+* @brief Struct to store HID report statistics.
+* @param reports HID reports sent.
+* @param merged Movements and button transitions sent in the
+*        report of another one.
+* @param dropped Button transitions lost on a full output stage.
+* @param split Extra reports carrying the excess of a movement
+*        too large for one report.
+*************************************************************/
+struct HmHidStats {
+    uint32_t reports = 0;
+    uint32_t merged = 0;
+    uint32_t dropped = 0;
+    uint32_t split = 0;
+};
+
+/*! *********************************************************
+* @brief Struct to store program cycle statistics.
+* @param cycles Number of program cycles run.
+* @param missed_ticks Timer ticks without own program cycle.
+* @param coalesced_cycles Program cycles run for more than one tick.
+* @param cycle_max_us Worst-case program cycle time [us], from
+*        the timer tick handling to the HID output.
+* @param dropped_samples IMU samples lost on a full motion queue.
+* @param dropped_moves Mouse movements lost on a full HID queue.
+* @param task_us Time spent per task [us].
+* @param start_us Time of the last statistics reset [us].
+* @param sample IMU sample statistics.
+* @param button Button statistics.
+* @param hid HID report statistics.
+*************************************************************/
+struct HmCycleStats {
+    uint32_t cycles = 0;
+    uint32_t missed_ticks = 0;
+    uint32_t coalesced_cycles = 0;
+    uint32_t cycle_max_us = 0;
+    uint32_t dropped_samples = 0;
+    uint32_t dropped_moves = 0;
+    uint64_t task_us[CYCLE_TASK_COUNT] = {0};
+    int64_t start_us = 0;
+    HmSampleStats sample;
+    HmButtonStats button;
+    HmHidStats hid;
+};
+
+/*! *********************************************************
+* @brief Adds the time until the end of the scope to a task
+*        of the program cycle statistics.
+*************************************************************/
+class CycleTaskTimer {
+    private:
+    HmCycleStats& _stats;
+    CycleTask _task;
+    int64_t _start_us;
+
+    public:
+    CycleTaskTimer(HmCycleStats& stats, CycleTask task)
+        : _stats(stats), _task(task), _start_us(esp_timer_get_time()) {}
+    ~CycleTaskTimer(){ _stats.task_us[_task] += (uint64_t)(esp_timer_get_time() - _start_us); }
+};
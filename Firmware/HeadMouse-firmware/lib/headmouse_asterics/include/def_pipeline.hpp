@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+
+/* TASK PIPELINE ****************************************************/
+/* Sensor -> motion -> HID output, housekeeping runs beside.        */
+/* Priorities descend along the pipeline, so a sample is passed on  */
+/* before the next one is read and housekeeping never delays motion.*/
+constexpr uint32_t PIPELINE_QUEUE_SIZE = 8;         // Items per SPSC queue between two stages
+constexpr uint32_t TASK_WAIT_TIMEOUT_MS = 100;      // Maximum time a task waits for its signal
+constexpr uint32_t TASK_STACK_SIZE = 4096;          // [bytes]
+
+/* CORE LAYOUT ******************************************************/
+/* The Bluedroid host and BLE controller tasks run on core 0 (PRO   */
+/* CPU). Sensor and motion task get core 1 (APP CPU) to themselves, */
+/* so BLE bursts cannot preempt them. HID and housekeeping share    */
+/* core 0 with the BLE stack they talk to. -DHM_CORE_LAYOUT_SHARED  */
+/* moves the whole pipeline to core 0 for comparison.               */
+constexpr int CORE_BLE = 0;
+#ifdef HM_CORE_LAYOUT_SHARED
+constexpr int CORE_MOTION = CORE_BLE;
+#else
+constexpr int CORE_MOTION = 1;
+#endif
+constexpr int TASK_CORE_SENSOR = CORE_MOTION;
+constexpr int TASK_CORE_MOTION = CORE_MOTION;
+constexpr int TASK_CORE_HID = CORE_BLE;
+constexpr int TASK_CORE_HOUSEKEEPING = CORE_BLE;
+
+constexpr uint32_t TASK_PRIO_SENSOR = 5;
+constexpr uint32_t TASK_PRIO_MOTION = 4;
+constexpr uint32_t TASK_PRIO_HID = 3;
+constexpr uint32_t TASK_PRIO_HOUSEKEEPING = 1;      // Same as the Arduino loop task
+
+/* JOBS *************************************************************/
+/* Periods of the rate-monotonic job scheduler. The housekeeping    */
+/* task runs the device status jobs; motion is a job of the main    */
+/* loop with HM_SINGLE_LOOP only, the task pipeline has its own.    */
+constexpr uint32_t JOB_PERIOD_MOTION_MS = 10;           // 100 Hz
+constexpr uint32_t JOB_PERIOD_STATUS_MS = 100;          // 10 Hz, BLE connection and charging state
+constexpr uint32_t JOB_PERIOD_CALIBRATION_MS = 500;     // 2 Hz, IMU calibration state over I2C
+constexpr uint32_t JOB_PERIOD_BATTERY_MS = 5000;        // 0.2 Hz, battery voltage ADC
+
+/*! *********************************************************
+* @brief Enum to define the scheduler jobs
+*************************************************************/
+enum HmJob {
+    JOB_MOTION,
+    JOB_STATUS,
+    JOB_CALIBRATION,
+    JOB_BATTERY,
+    JOB_LEDS,       // Triggered on device status changes
+    JOB_COUNT
+};
+
+/*! *********************************************************
+* @brief IMU sample passed from sensor to motion task.
+* @param cycle_start_us Start of the program cycle [us].
+* @param timestamp_us Time of the read [us].
+* @param quat Raw orientation quaternion w, x, y, z (1 LSB = 2^-14).
+*************************************************************/
+struct ImuSample {
+    int64_t cycle_start_us;
+    int64_t timestamp_us;
+    int16_t quat[4];
+};
+
+/*! *********************************************************
+* @brief Mouse movement passed from motion to HID task.
+* @param cycle_start_us Start of the program cycle [us].
+* @param x Horizontal movement [counts] or position if absolute.
+* @param y Vertical movement [counts] or position if absolute.
+* @param is_absolute TRUE if x/y are an absolute screen position
+*        (absolute mode).
+* @param wheel Wheel movement [1/WHEEL_HIRES_MULTIPLIER detents].
+* @param pan Horizontal wheel movement [1/WHEEL_HIRES_MULTIPLIER 
+*        detents].
+*************************************************************/
+struct MouseMove {
+    int64_t cycle_start_us;
+    int32_t x;
+    int32_t y;
+    bool is_absolute;
+    int32_t wheel;
+    int32_t pan;
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 #include "BleMouse.h"
+#include "hm_board_config_v1_0.hpp"
 
 namespace preferences{
     /*! *********************************************************
@@ -8,20 +9,46 @@ namespace preferences{
     *************************************************************/
     typedef uint32_t devSensitivity;
 
-    constexpr char* STORE_MODE = "mode";
-    constexpr char* STORE_SENSITIVITY = "sensitivity";
-    constexpr char* STORE_BTN[4] = {"button0", "button1", "button2", "button3"};
+    constexpr const char* STORE_MODE = "mode";
+    constexpr const char* STORE_SENSITIVITY = "sensitivity";
+    constexpr const char* STORE_BTN[4] = {"button0", "button1", "button2", "button3"};
+    constexpr const char* STORE_GESTURES = "gestures";
+
+    /* Button gesture timing windows [ms] */
+    constexpr uint16_t GESTURE_HOLD_DEF_MS = 200;       // Pushes held longer are a long press
+    constexpr uint16_t GESTURE_GAP_DEF_MS = 250;        // Max. release time between the clicks of a double/triple click
+    constexpr uint16_t GESTURE_TIME_MIN_MS = 50;
+    constexpr uint16_t GESTURE_TIME_MAX_MS = 5000;
 
     constexpr int SCALING_FACTOR = 1000000;   // Used to bring calculations from float to int with necessary accuracy
     constexpr int JITTER_OFFSET = (int)(0.00003*SCALING_FACTOR);       // [RAD]*scaling factor
     constexpr int SLOW_MOTION_OFFSET = (int)(0.001*SCALING_FACTOR);   // [RAD]*scaling factor
+    /* Fixed-point motion pipeline: head rotation per cycle in [RAD]*2^MOTION_Q_SHIFT, 
+       mouse counts = rotation * sensitivity * MOTION_GAIN_PER_SENSITIVITY / 2^MOTION_Q_SHIFT */
+    constexpr int MOTION_Q_SHIFT = 20;
+    constexpr int32_t MOTION_Q_ONE = (int32_t)1 << MOTION_Q_SHIFT;
+    constexpr int32_t MOTION_DELTA_MAX = MOTION_Q_ONE / 4;      // Max. rotation per cycle (0.25 rad), keeps products within int32
+    constexpr int32_t MOTION_GAIN_PER_SENSITIVITY = SCALING_FACTOR / 20000;
+    constexpr int32_t toMotionQ(int32_t scaled_rad){ return (int32_t)(((int64_t)scaled_rad * MOTION_Q_ONE) / SCALING_FACTOR); }
+    constexpr int32_t JITTER_OFFSET_Q = toMotionQ(JITTER_OFFSET);
+    constexpr int32_t SLOW_MOTION_OFFSET_Q = toMotionQ(SLOW_MOTION_OFFSET);
+    /* Head angular velocity [RAD/s]*2^MOTION_V_SHIFT, calculated from the measured interval between IMU samples */
+    constexpr int MOTION_V_SHIFT = 16;
+    constexpr int32_t MOTION_V_MAX = (int32_t)64 << MOTION_V_SHIFT;    // 64 rad/s
+    constexpr uint32_t MOTION_DT_MIN_US = 1000;                         // Sample interval limits
+    constexpr uint32_t MOTION_DT_MAX_US = 100000;
+    constexpr int32_t toMotionVelocity(int32_t scaled_rad_per_cycle){ 
+        return (int32_t)((((int64_t)scaled_rad_per_cycle * 1000) << MOTION_V_SHIFT) / ((int64_t)SCALING_FACTOR * PROGRAM_CYCLE_INTERVAL_MS)); 
+    }
+    constexpr int32_t JITTER_VELOCITY_Q = toMotionVelocity(JITTER_OFFSET);
+
     constexpr devSensitivity SENSITIVITY_STEP = 7;
     constexpr devSensitivity SENSITIVITY_STEP_COUNT = 5;
     constexpr devSensitivity SENSITIVITY_MIN = 20;
     constexpr devSensitivity SENSITIVITY_MAX = SENSITIVITY_MIN + SENSITIVITY_STEP * (SENSITIVITY_STEP_COUNT-1);
     constexpr devSensitivity PREF_SENSITIVITY[SENSITIVITY_STEP_COUNT] = {SENSITIVITY_MIN, SENSITIVITY_MIN+SENSITIVITY_STEP, SENSITIVITY_MIN+SENSITIVITY_STEP*2, SENSITIVITY_MIN+SENSITIVITY_STEP*3, SENSITIVITY_MAX};
 
-    constexpr int SLOWMO_ANGLE_DEFLECTION[6] = {300, 440, 580, 580, 720, 860};
+    constexpr int SLOWMO_ANGLE_DEFLECTION[6] = {300, 440, 580, 720, 860, SLOW_MOTION_OFFSET};     // Slow-motion band limits [RAD]*scaling factor
     constexpr int SLOWMO_SENSITIVITY[5][5] = {
                                                 {20, 20, 20, 20, 20},
                                                 {20, 21, 22, 23, 24},
@@ -29,6 +56,66 @@ namespace preferences{
                                                 {20, 24, 27, 31, 34},
                                                 {20, 25, 31, 36, 40}
                                                 };
+
+    /* Pointer acceleration curves: control points (head angular velocity -> gain), one curve per sensitivity level */
+    constexpr int MOTION_CURVE_POINT_COUNT = 8;
+    constexpr uint16_t MOTION_CURVE_GAIN_MAX = (uint16_t)((INT32_MAX - MOTION_Q_ONE) / MOTION_DELTA_MAX);  // Keeps products within int32
+    constexpr const char* STORE_CURVE[SENSITIVITY_STEP_COUNT] = {"curve0", "curve1", "curve2", "curve3", "curve4"};
+
+    /*! *********************************************************
+    * @brief Control point of a pointer acceleration curve
+    * @param velocity Head angular velocity [mRAD/s]
+    * @param gain Mouse counts per head rotation [counts/RAD]
+    *************************************************************/
+    struct MotionCurvePoint{
+        uint16_t velocity;
+        uint16_t gain;
+    };
+
+    /*! *********************************************************
+    * @brief Pointer acceleration curve
+    *
+    * The gain is interpolated linearly between the control points 
+    * (ascending velocity) and kept constant below the first and 
+    * above the last point.
+    *************************************************************/
+    struct MotionCurve{
+        uint8_t point_count;
+        MotionCurvePoint points[MOTION_CURVE_POINT_COUNT];
+    };
+
+    /*! *********************************************************
+    * @brief Default curve of a sensitivity level: SLOWMO_SENSITIVITY 
+    *        at the slow-motion band limits, the sensitivity level 
+    *        at SLOW_MOTION_OFFSET and above.
+    *
+    * @param level Sensitivity level (index of PREF_SENSITIVITY).
+    * @return Pointer acceleration curve.
+    *************************************************************/
+    constexpr MotionCurve makeDefaultMotionCurve(int level){
+        MotionCurve curve = {};
+        curve.point_count = 6;
+        for(int i=0; i<6; i++){
+            int32_t sensitivity = (i < 5) ? SLOWMO_SENSITIVITY[i][level] : (int32_t)PREF_SENSITIVITY[level];
+            curve.points[i].velocity = (uint16_t)(SLOWMO_ANGLE_DEFLECTION[i] / (int32_t)PROGRAM_CYCLE_INTERVAL_MS);
+            curve.points[i].gain = (uint16_t)(sensitivity * MOTION_GAIN_PER_SENSITIVITY);
+        }
+        return curve;
+    }
+
+    constexpr MotionCurve MOTION_CURVE_DEFAULT[SENSITIVITY_STEP_COUNT] = {makeDefaultMotionCurve(0), makeDefaultMotionCurve(1), 
+                                                                         makeDefaultMotionCurve(2), makeDefaultMotionCurve(3), 
+                                                                         makeDefaultMotionCurve(4)};
+
+    /* Absolute mode: head rotation from the centre pose to the screen edges, one range per sensitivity level */
+    constexpr uint16_t ABS_RANGE_X_MRAD[SENSITIVITY_STEP_COUNT] = {1000, 870, 740, 610, 480};   // Left to right edge
+    constexpr uint16_t ABS_RANGE_Y_MRAD[SENSITIVITY_STEP_COUNT] = {620, 540, 460, 380, 300};    // Top to bottom edge
+    constexpr uint16_t ABS_DEADBAND_URAD = 250;     // Rotation the pointer ignores when reversing, ~2 LSB of the BNO055 quaternion
+
+    /* Scroll mode: head angular velocity -> wheel counts [1/WHEEL_HIRES_MULTIPLIER detents per RAD] */
+    constexpr uint16_t SCROLL_DEADBAND_MRAD_S = 300;    // Slower head rotation does not scroll, e.g. while reading
+    constexpr int32_t SCROLL_DEADBAND_VELOCITY_Q = ((int32_t)SCROLL_DEADBAND_MRAD_S << MOTION_V_SHIFT) / 1000;
+    constexpr MotionCurve SCROLL_CURVE = {3, {{SCROLL_DEADBAND_MRAD_S, 50}, {1500, 80}, {3000, 110}}};
 }
 
 using namespace preferences;
@@ -50,7 +137,38 @@ enum btnAction {
     LEFT = MOUSE_LEFT,
     RIGHT = MOUSE_RIGHT,
     SENSITIVITY,
-    DEVICE_CONN_AND_CONFIG
+    DEVICE_CONN_AND_CONFIG,
+    DRAG_LOCK,          // Toggle the left mouse button between held and released
+    DOUBLE_CLICK,       // Left mouse button double click
+    RECENTER,           // Absolute mode: the current head pose points to the screen centre
+    SCROLL,             // Toggle scroll mode (click) or scroll while held (long press)
+    BTN_ACTION_COUNT
+};
+
+/*! *********************************************************
+* @brief Enum to define the button gestures
+*************************************************************/
+enum btnGesture {
+    GESTURE_CLICK,
+    GESTURE_DOUBLE_CLICK,
+    GESTURE_TRIPLE_CLICK,
+    GESTURE_LONG_PRESS,     // Action starts after the hold time and ends on release
+    GESTURE_CHORD_CLICK,    // Click while another button is held
+    GESTURE_COUNT
+};
+
+/*! *********************************************************
+* @brief Gesture timing and gesture to action map of the buttons.
+* @param hold_ms Pushes held longer are a long press [ms].
+* @param gap_ms Max. release time between the clicks of a double
+*        or triple click [ms].
+* @param actions btnAction per button and btnGesture, multi-click
+*        and chord gestures are only awaited if mapped.
+*************************************************************/
+struct GestureConfig {
+    uint16_t hold_ms = GESTURE_HOLD_DEF_MS;
+    uint16_t gap_ms = GESTURE_GAP_DEF_MS;
+    uint8_t actions[4][GESTURE_COUNT] = {};
 };
 
 /*! *********************************************************
@@ -58,9 +176,15 @@ enum btnAction {
 * @param mode Mouse control mode
 * @param sensititvity Level of movement sensitivity
 * @param btn_actions Array of [4] button actions
+* @param curves Pointer acceleration curve per sensitivity level
+* @param gestures Button gestures, derived from btn_actions if no
+*        action is mapped
 *************************************************************/
 struct HmPreferences{
     devMode mode = ABSOLUTE;
     devSensitivity sensititvity = PREF_SENSITIVITY[4];
     btnAction btn_actions[4] = {NONE, NONE, NONE, NONE};
+    MotionCurve curves[SENSITIVITY_STEP_COUNT] = {MOTION_CURVE_DEFAULT[0], MOTION_CURVE_DEFAULT[1], MOTION_CURVE_DEFAULT[2], 
+                                                  MOTION_CURVE_DEFAULT[3], MOTION_CURVE_DEFAULT[4]};
+    GestureConfig gestures;
 };
\ No newline at end of file
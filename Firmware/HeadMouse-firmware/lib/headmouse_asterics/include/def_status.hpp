@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 /************************************************************
 * Battery level voltage defintions
 *************************************************************/
@@ -9,6 +11,31 @@ constexpr float BAT_HIGH_V = 3.9;
 constexpr float BAT_OK_V = 3.5;
 constexpr float BAT_LOW_V = 3.3;
 
+/************************************************************
+* Battery level estimation
+*************************************************************/
+constexpr uint32_t BAT_DIVIDER = 2;             // 50:50 voltage divider at PIN_VBATT_MEASURE
+constexpr uint32_t BAT_ADC_OVERSAMPLING = 8;    // ADC reads averaged per measurement
+constexpr uint32_t BAT_FILTER_SHIFT = 4;        // Low pass weight 2^-4 per measurement, ~80 s time constant at 0.2 Hz
+constexpr uint32_t BAT_CHARGE_OFFSET_MV = 120;  // Voltage raised by the charge current (charge current * cell resistance)
+
+/*! *********************************************************
+* @brief Point of the battery discharge curve
+* @param voltage_mv Open circuit cell voltage [mV].
+* @param percent Remaining charge [%].
+*************************************************************/
+struct BatCurvePoint {
+    uint16_t voltage_mv;
+    uint8_t percent;
+};
+
+/* Typical 1C LiPo discharge curve, descending voltages */
+constexpr uint32_t BAT_CURVE_POINT_COUNT = 12;
+constexpr BatCurvePoint BAT_CURVE[BAT_CURVE_POINT_COUNT] = {
+    {4200, 100}, {4100, 90}, {4000, 80}, {3930, 70}, {3870, 60}, {3830, 50},
+    {3790, 40}, {3760, 30}, {3730, 20}, {3690, 10}, {3600, 5}, {3300, 0}
+};
+
 
 
 /*! *********************************************************
@@ -22,6 +49,27 @@ enum BatStatus {
     BAT_FULL
 };
 
+/*! *********************************************************
+* @brief Enum to define the requested BLE connection parameters
+*************************************************************/
+enum ConnProfile {
+    CONN_PROFILE_NONE,      // Not connected, nothing requested
+    CONN_PROFILE_ACTIVE,    // Short interval while the head moves
+    CONN_PROFILE_IDLE       // Long interval and slave latency while the head rests
+};
+
+/*! *********************************************************
+* @brief Struct to store the negotiated BLE connection parameters.
+* @param interval_us Connection interval [us], 0 if not connected.
+* @param latency Slave latency [connection events].
+* @param timeout_ms Supervision timeout [ms].
+*************************************************************/
+struct HmConnParams {
+    uint32_t interval_us = 0;
+    uint16_t latency = 0;
+    uint32_t timeout_ms = 0;
+};
+
 /*! *********************************************************
 * @brief Struct to store current HeadMouse device state.
 * @param is_error   TRUE if error occured (eg. hardware component not 
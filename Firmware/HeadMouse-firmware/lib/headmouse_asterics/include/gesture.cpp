@@ -0,0 +1,263 @@
+#include "gesture.hpp"
+
+/* State transitions, rows: State, columns: Input */
+static constexpr GestureFsm::Transition TRANSITIONS[GestureFsm::STATE_COUNT][GestureFsm::INPUT_COUNT] = {
+    /*                IN_DOWN                          IN_UP                                 IN_UP_SHORT                          IN_HOLD_TIMEOUT                       IN_GAP_TIMEOUT */
+    /* IDLE */      {{GestureFsm::PRESSED, GestureFsm::OP_START}, {GestureFsm::IDLE, GestureFsm::OP_NONE},      {GestureFsm::IDLE, GestureFsm::OP_NONE},     {GestureFsm::IDLE, GestureFsm::OP_NONE},          {GestureFsm::IDLE, GestureFsm::OP_NONE}},
+    /* PRESSED */   {{GestureFsm::PRESSED, GestureFsm::OP_NONE},  {GestureFsm::RELEASED, GestureFsm::OP_CLICK}, {GestureFsm::RELEASED, GestureFsm::OP_NONE}, {GestureFsm::HELD, GestureFsm::OP_LONG_START},  {GestureFsm::PRESSED, GestureFsm::OP_NONE}},
+    /* HELD */      {{GestureFsm::HELD, GestureFsm::OP_NONE},     {GestureFsm::IDLE, GestureFsm::OP_LONG_END},  {GestureFsm::IDLE, GestureFsm::OP_LONG_END}, {GestureFsm::HELD, GestureFsm::OP_NONE},          {GestureFsm::HELD, GestureFsm::OP_NONE}},
+    /* RELEASED */  {{GestureFsm::PRESSED, GestureFsm::OP_START}, {GestureFsm::RELEASED, GestureFsm::OP_NONE},  {GestureFsm::RELEASED, GestureFsm::OP_NONE}, {GestureFsm::RELEASED, GestureFsm::OP_NONE},      {GestureFsm::IDLE, GestureFsm::OP_EMIT_CLICKS}}
+};
+
+static constexpr btnGesture MULTI_CLICK_GESTURE[4] = {GESTURE_CLICK, GESTURE_CLICK, GESTURE_DOUBLE_CLICK, GESTURE_TRIPLE_CLICK};
+
+/************************************************************
+ * @brief Check a gesture config.
+ *
+ * @param config Gesture config.
+ * @return TRUE if timing windows and actions are in range.
+ *************************************************************/
+bool GestureFsm::isValid(const GestureConfig& config){
+    if((config.hold_ms < GESTURE_TIME_MIN_MS) || (config.hold_ms > GESTURE_TIME_MAX_MS)) return false;
+    if((config.gap_ms < GESTURE_TIME_MIN_MS) || (config.gap_ms > GESTURE_TIME_MAX_MS)) return false;
+    for(int i=0; i<BUTTON_COUNT; i++){
+        for(int j=0; j<GESTURE_COUNT; j++){
+            if(config.actions[i][j] >= BTN_ACTION_COUNT) return false;
+        }
+    }
+    return true;
+}
+
+/************************************************************
+ * @brief Check if a gesture config maps any action.
+ *
+ * @param config Gesture config.
+ * @return TRUE if at least one gesture has an action.
+ *************************************************************/
+bool GestureFsm::isMapped(const GestureConfig& config){
+    for(int i=0; i<BUTTON_COUNT; i++){
+        for(int j=0; j<GESTURE_COUNT; j++){
+            if(config.actions[i][j] != NONE) return true;
+        }
+    }
+    return false;
+}
+
+/************************************************************
+ * @brief Gesture config of plain button actions.
+ *
+ * Reproduces the fixed button behaviour: a click runs the action,
+ * a long press holds LEFT/RIGHT or enters the config mode.
+ *
+ * @param actions Array of [4] button actions.
+ * @return Gesture config with default timing.
+ *************************************************************/
+GestureConfig GestureFsm::defaultConfig(const btnAction* actions){
+    GestureConfig config;
+
+    for(int i=0; i<BUTTON_COUNT; i++){
+        config.actions[i][GESTURE_CLICK] = actions[i];
+        config.actions[i][GESTURE_LONG_PRESS] = (actions[i] == SENSITIVITY) ? NONE : actions[i];
+    }
+    return config;
+}
+
+/************************************************************
+ * @brief Set timing windows and gesture to action map.
+ *
+ * Resets all buttons to IDLE.
+ *
+ * @param config Valid gesture config.
+ *************************************************************/
+void GestureFsm::setConfig(const GestureConfig& config){
+    _config = config;
+    for(int i=0; i<BUTTON_COUNT; i++){
+        Button& button = _buttons[i];
+        button = Button();
+        button.max_clicks = (config.actions[i][GESTURE_TRIPLE_CLICK] != NONE) ? 3 : (config.actions[i][GESTURE_DOUBLE_CLICK] != NONE) ? 2 : 1;
+    }
+}
+
+/************************************************************
+ * @brief Feed a button event.
+ *
+ * Timeouts up to the event time are handled first. Only down and
+ * up events are used, the timing is done by the gesture windows.
+ *
+ * @param event Button event.
+ *************************************************************/
+void GestureFsm::handleEvent(const BtnEvent& event){
+    if(event.button >= BUTTON_COUNT) return;
+
+    update(event.timestamp_us);
+    if(event.type == BTN_DOWN){
+        _input(event.button, IN_DOWN, event.timestamp_us);
+    }
+    else if(event.type == BTN_UP){
+        bool is_short = (event.timestamp_us - _buttons[event.button].down_us) < (int64_t)GESTURE_PUSH_MIN_US;
+        _input(event.button, is_short ? IN_UP_SHORT : IN_UP, event.timestamp_us);
+    }
+}
+
+/************************************************************
+ * @brief Handle expired hold and multi-click windows.
+ *
+ * @param now_us Current time [us].
+ *************************************************************/
+void GestureFsm::update(int64_t now_us){
+    for(int i=0; i<BUTTON_COUNT; i++){
+        Button& button = _buttons[i];
+        int64_t hold_end_us = button.down_us + (int64_t)_config.hold_ms*1000;
+        int64_t gap_end_us = button.up_us + (int64_t)_config.gap_ms*1000;
+
+        if((button.state == PRESSED) && (now_us >= hold_end_us)) _input(i, IN_HOLD_TIMEOUT, hold_end_us);
+        else if((button.state == RELEASED) && (now_us >= gap_end_us)) _input(i, IN_GAP_TIMEOUT, gap_end_us);
+    }
+}
+
+/************************************************************
+ * @brief Get the oldest recognised gesture.
+ *
+ * @param gesture Output: gesture.
+ * @return TRUE if a gesture was available, FALSE otherwise.
+ *************************************************************/
+bool GestureFsm::popGesture(GestureOutput* gesture){
+    return _output.pop(gesture);
+}
+
+/************************************************************
+ * @brief Check if a button only maps a mouse button to click and
+ *        long press, so its state can be forwarded directly.
+ *
+ * @param index Button index.
+ * @return TRUE if the button needs no gesture recognition.
+ *************************************************************/
+bool GestureFsm::isPassThrough(int index){
+    if((index < 0) || (index >= BUTTON_COUNT)) return false;
+
+    const uint8_t* actions = _config.actions[index];
+    return ((actions[GESTURE_CLICK] == LEFT) || (actions[GESTURE_CLICK] == RIGHT)) && 
+           (actions[GESTURE_LONG_PRESS] == actions[GESTURE_CLICK]) && (actions[GESTURE_DOUBLE_CLICK] == NONE) && 
+           (actions[GESTURE_TRIPLE_CLICK] == NONE) && (actions[GESTURE_CHORD_CLICK] == NONE);
+}
+
+uint32_t GestureFsm::getDropped(){
+    return _dropped;
+}
+
+/************************************************************
+ * @brief Run a state transition of a button.
+ *
+ * @param index Button index.
+ * @param input Input of the state machine.
+ * @param timestamp_us Time of the input [us].
+ *************************************************************/
+void GestureFsm::_input(int index, Input input, int64_t timestamp_us){
+    Button& button = _buttons[index];
+    const Transition& transition = TRANSITIONS[button.state][input];
+
+    button.state = transition.next;
+    switch(transition.op){
+        case OP_START:
+            button.down_us = timestamp_us;
+        break;
+
+        case OP_CLICK:
+            button.clicks++;
+            button.up_us = timestamp_us;
+            /* Emit without waiting for the multi-click window if no further click is awaited or it is a chord */
+            if((button.clicks >= button.max_clicks) || 
+               ((button.clicks == 1) && (_config.actions[index][GESTURE_CHORD_CLICK] != NONE) && _isOtherPushed(index))){
+                _emitClicks(index, timestamp_us);
+                if(button.clicks == 0) button.state = IDLE;
+            }
+        break;
+
+        case OP_EMIT_CLICKS:
+            _emitClicks(index, timestamp_us);
+            button.clicks = 0;
+        break;
+
+        case OP_LONG_START:
+            _emitClicks(index, timestamp_us);   /* Clicks before the long press */
+            button.clicks = 0;
+            if(!button.is_chord_member){
+                _emit(index, GESTURE_LONG_PRESS, true, timestamp_us);
+                button.is_long_started = true;
+            }
+        break;
+
+        case OP_LONG_END:
+            if(button.is_long_started) _emit(index, GESTURE_LONG_PRESS, false, timestamp_us);
+            button.is_long_started = false;
+            button.is_chord_member = false;
+        break;
+
+        default: /* OP_NONE */
+        break;
+    }
+}
+
+/************************************************************
+ * @brief Emit the counted clicks of a button.
+ *
+ * A single click while another button is pushed is a chord click
+ * (if mapped); the pushed buttons then emit no further gesture
+ * until released. Multi-clicks without mapped action are
+ * emitted as single clicks.
+ *
+ * @param index Button index.
+ * @param timestamp_us Time completing the gesture [us].
+ *************************************************************/
+void GestureFsm::_emitClicks(int index, int64_t timestamp_us){
+    Button& button = _buttons[index];
+    uint8_t clicks = button.clicks;
+
+    if(clicks == 0) return;
+    if(button.is_chord_member){
+        /* Chord button released, it has already been used by the chord */
+        if(button.state != HELD) button.is_chord_member = false;
+        button.clicks = 0;
+        return;
+    }
+
+    if((clicks == 1) && (_config.actions[index][GESTURE_CHORD_CLICK] != NONE)){
+        bool is_chord = false;
+        for(int i=0; i<BUTTON_COUNT; i++){
+            if((i == index) || ((_buttons[i].state != PRESSED) && (_buttons[i].state != HELD))) continue;
+            _buttons[i].is_chord_member = true;
+            is_chord = true;
+        }
+        if(is_chord){
+            _emit(index, GESTURE_CHORD_CLICK, true, timestamp_us);
+            button.clicks = 0;
+            return;
+        }
+    }
+
+    btnGesture gesture = MULTI_CLICK_GESTURE[(clicks < 3) ? clicks : 3];
+    if((clicks > 1) && (_config.actions[index][gesture] == NONE)){
+        for(uint8_t i=0; i<clicks; i++) _emit(index, GESTURE_CLICK, true, timestamp_us);
+    }
+    else _emit(index, gesture, true, timestamp_us);
+    button.clicks = 0;
+}
+
+/************************************************************
+ * @brief Check if another button than the given one is pushed.
+ *************************************************************/
+bool GestureFsm::_isOtherPushed(int index){
+    for(int i=0; i<BUTTON_COUNT; i++){
+        if((i != index) && ((_buttons[i].state == PRESSED) || (_buttons[i].state == HELD))) return true;
+    }
+    return false;
+}
+
+/************************************************************
+ * @brief Queue a recognised gesture.
+ *************************************************************/
+void GestureFsm::_emit(int index, btnGesture gesture, bool is_start, int64_t timestamp_us){
+    GestureOutput output = {timestamp_us, (uint8_t)index, gesture, is_start};
+
+    if(!_output.push(output)) _dropped++;
+}
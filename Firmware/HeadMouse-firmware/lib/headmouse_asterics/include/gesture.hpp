@@ -0,0 +1,75 @@
+#pragma once
+
+#include "def_preferences.hpp"
+#include "button.hpp"
+#include "spsc_queue.hpp"
+
+constexpr uint32_t GESTURE_QUEUE_SIZE = 16;     // Recognised gestures buffered until the button actions run
+constexpr uint32_t GESTURE_PUSH_MIN_US = 20000; // Shorter pushes are no click (button debounce lockout)
+
+/*! *********************************************************
+* @brief Recognised gesture of a button.
+* @param timestamp_us Time of the edge or timeout completing the
+*        gesture [us].
+* @param button Button index.
+* @param gesture Gesture.
+* @param is_start FALSE for the end of a long press, TRUE otherwise.
+*************************************************************/
+struct GestureOutput {
+    int64_t timestamp_us;
+    uint8_t button;
+    btnGesture gesture;
+    bool is_start;
+};
+
+/*! *********************************************************
+* @brief Table-driven gesture recognition of the buttons.
+*
+* Every button runs its own state machine on the button down/up
+* events and the timing windows of the GestureConfig. Time only 
+* enters through the event timestamps and update(), so it runs 
+* unchanged on the host with simulated edge timing.
+*************************************************************/
+class GestureFsm {
+    public:
+    enum State : uint8_t { IDLE, PRESSED, HELD, RELEASED, STATE_COUNT };
+    enum Input : uint8_t { IN_DOWN, IN_UP, IN_UP_SHORT, IN_HOLD_TIMEOUT, IN_GAP_TIMEOUT, INPUT_COUNT };
+    enum Op : uint8_t { OP_NONE, OP_START, OP_CLICK, OP_EMIT_CLICKS, OP_LONG_START, OP_LONG_END };
+
+    struct Transition {
+        State next;
+        Op op;
+    };
+
+    private:
+    struct Button {
+        State state;
+        uint8_t clicks;         // Clicks counted for a multi-click
+        uint8_t max_clicks;     // Clicks emitted without waiting for another one
+        bool is_chord_member;   // Held button of a chord, its own gestures are suppressed
+        bool is_long_started;   // Long press start emitted, end pending
+        int64_t down_us;
+        int64_t up_us;
+    };
+    GestureConfig _config;
+    Button _buttons[BUTTON_COUNT] = {};
+    SpscQueue<GestureOutput, GESTURE_QUEUE_SIZE> _output;
+    uint32_t _dropped = 0;
+
+    void _input(int index, Input input, int64_t timestamp_us);
+    void _emit(int index, btnGesture gesture, bool is_start, int64_t timestamp_us);
+    void _emitClicks(int index, int64_t timestamp_us);
+    bool _isOtherPushed(int index);
+
+    public:
+    static bool isValid(const GestureConfig& config);
+    static bool isMapped(const GestureConfig& config);
+    static GestureConfig defaultConfig(const btnAction* actions);
+
+    void setConfig(const GestureConfig& config);
+    void handleEvent(const BtnEvent& event);
+    void update(int64_t now_us);
+    bool popGesture(GestureOutput* gesture);
+    bool isPassThrough(int index);
+    uint32_t getDropped();
+};
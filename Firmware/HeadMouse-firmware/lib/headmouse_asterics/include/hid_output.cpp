@@ -0,0 +1,232 @@
+#include "hid_output.hpp"
+
+/* Take the part of a movement fitting into one report, the excess stays */
+static inline int32_t _takeDelta(int32_t* delta, int32_t max){
+    int32_t part = (*delta > max) ? max : (*delta < -max) ? -max : *delta;
+    *delta -= part;
+    return part;
+}
+
+/************************************************************
+ * @brief Set the minimum time between two reports.
+ *
+ * @param interval_us BLE connection interval [us].
+ *************************************************************/
+void HidOutput::setInterval(uint32_t interval_us){
+    _interval_us = interval_us;
+}
+
+uint32_t HidOutput::getInterval(){
+    return _interval_us;
+}
+
+/************************************************************
+ * @brief Add a movement to the next report.
+ *
+ * @param x Horizontal movement [counts].
+ * @param y Vertical movement [counts].
+ * @param wheel Wheel movement [counts].
+ * @param pan Horizontal wheel movement [counts].
+ *************************************************************/
+void HidOutput::move(int32_t x, int32_t y, int32_t wheel, int32_t pan){
+    if((x == 0) && (y == 0) && (wheel == 0) && (pan == 0)) return;
+
+    if((x != 0) || (y != 0)){
+        _is_absolute = false;
+        _is_abs_pending = false;
+    }
+    _x += x;
+    _y += y;
+    _wheel += wheel;
+    _pan += pan;
+    _move_requests++;
+}
+
+/************************************************************
+ * @brief Set the absolute position of the next report.
+ *
+ * Replaces a pending position and discards pending relative
+ * movements.
+ *
+ * @param x Horizontal position (0..ABS_POSITION_MAX).
+ * @param y Vertical position (0..ABS_POSITION_MAX).
+ * @return TRUE if the position has changed, FALSE otherwise.
+ *************************************************************/
+bool HidOutput::moveTo(int32_t x, int32_t y){
+    if(_is_absolute && (x == _abs_x) && (y == _abs_y)) return false;
+
+    _is_absolute = true;
+    _is_abs_pending = true;
+    _abs_x = x;
+    _abs_y = y;
+    _x = 0;
+    _y = 0;
+    _move_requests++;
+    return true;
+}
+
+/************************************************************
+ * @brief Check if the reports carry an absolute position.
+ *************************************************************/
+bool HidOutput::isAbsolute(){
+    return _is_absolute;
+}
+
+/************************************************************
+ * @brief Press mouse buttons.
+ *
+ * @param b Mouse buttons (MOUSE_xxx).
+ * @param source_us Time of the button event [us].
+ *************************************************************/
+void HidOutput::press(uint8_t b, int64_t source_us){
+    _setButtons(_buttons | b, source_us);
+}
+
+/************************************************************
+ * @brief Release mouse buttons.
+ *
+ * @param b Mouse buttons (MOUSE_xxx).
+ * @param source_us Time of the button event [us].
+ *************************************************************/
+void HidOutput::release(uint8_t b, int64_t source_us){
+    _setButtons(_buttons & ~b, source_us);
+}
+
+/************************************************************
+ * @brief Press and release mouse buttons in two reports.
+ *
+ * @param b Mouse buttons (MOUSE_xxx).
+ * @param source_us Time of the button event [us].
+ *************************************************************/
+void HidOutput::click(uint8_t b, int64_t source_us){
+    press(b, source_us);
+    release(b, source_us);
+}
+
+/************************************************************
+ * @brief Check mouse buttons, including pending transitions.
+ *
+ * @param b Mouse buttons (MOUSE_xxx).
+ * @return TRUE if any of the buttons is pressed.
+ *************************************************************/
+bool HidOutput::isPressed(uint8_t b){
+    return ((_buttons & b) != 0);
+}
+
+bool HidOutput::isPending(){
+    return (_transition_count > 0) || (_move_requests > 0) || _is_abs_pending || (_x != 0) || (_y != 0) || (_wheel != 0) || (_pan != 0);
+}
+
+/************************************************************
+ * @brief Get the time to wait for the next report.
+ *
+ * @param now_us Current time [us].
+ * @param timeout_ms Wait time if nothing is pending [ms].
+ * @return Time until the next report is due (at least 1 ms) or
+ *         timeout_ms, whatever is shorter [ms].
+ *************************************************************/
+uint32_t HidOutput::getWaitMs(int64_t now_us, uint32_t timeout_ms){
+    if(!isPending()) return timeout_ms;
+
+    int64_t wait_us = _last_report_us + _interval_us - now_us;
+    uint32_t wait_ms = (wait_us > 0) ? (uint32_t)((wait_us + 999) / 1000) : 1;
+    return (wait_ms < timeout_ms) ? wait_ms : timeout_ms;
+}
+
+/************************************************************
+ * @brief Get the next report if one is pending and the connection
+ *        interval since the last report has passed.
+ *
+ * Call until it returns FALSE: the excess of a large movement is
+ * split into extra reports which are due immediately.
+ *
+ * @param now_us Current time [us].
+ * @param report Output: report to send.
+ * @return TRUE if a report is due, FALSE otherwise.
+ *************************************************************/
+bool HidOutput::popReport(int64_t now_us, HidReport* report){
+    bool is_due = ((now_us - _last_report_us) >= (int64_t)_interval_us);
+    /* Only the excess of the last report, new movements wait for the next interval */
+    bool is_split = !is_due && (_split_count < HID_SPLIT_REPORT_MAX) && (_move_requests == 0) && 
+                    ((_x != 0) || (_y != 0) || (_wheel != 0) || (_pan != 0));
+
+    if(!isPending() || (!is_due && !is_split)) return false;
+
+    report->source_us = 0;
+    report->buttons = _sent_buttons;
+    report->requests = _move_requests;
+    report->is_split = is_split;
+    report->is_absolute = _is_absolute;
+    if((_transition_count > 0) && !is_split){
+        report->source_us = _transition_us[0];
+        report->buttons = _transitions[0];
+        report->requests++;
+        _transition_count--;
+        for(uint32_t i=0; i<_transition_count; i++){
+            _transitions[i] = _transitions[i+1];
+            _transition_us[i] = _transition_us[i+1];
+        }
+    }
+    if(_is_absolute){
+        report->x = _abs_x;
+        report->y = _abs_y;
+        _is_abs_pending = false;
+    }
+    else{
+        report->x = _takeDelta(&_x, HID_DELTA_MAX);
+        report->y = _takeDelta(&_y, HID_DELTA_MAX);
+    }
+    report->wheel = _takeDelta(&_wheel, HID_WHEEL_MAX);
+    report->pan = _takeDelta(&_pan, HID_WHEEL_MAX);
+
+    _move_requests = 0;
+    _sent_buttons = report->buttons;
+    if(is_split) _split_count++;
+    else{
+        _split_count = 0;
+        _last_report_us = now_us;
+    }
+    return true;
+}
+
+/************************************************************
+ * @brief Discard pending movements and button transitions, the
+ *        button state is kept.
+ *************************************************************/
+void HidOutput::clear(){
+    _x = 0;
+    _y = 0;
+    _wheel = 0;
+    _pan = 0;
+    _is_absolute = false;
+    _is_abs_pending = false;
+    _move_requests = 0;
+    _transition_count = 0;
+    _sent_buttons = _buttons;
+}
+
+/************************************************************
+ * @brief Get the number of button transitions lost on a full
+ *        output stage.
+ *************************************************************/
+uint32_t HidOutput::getDropped(){
+    return _dropped;
+}
+
+/************************************************************
+ * @brief Queue a button transition.
+ *
+ * If the transitions are full, the newest one is overwritten, so 
+ * the final button state is always reported.
+ *************************************************************/
+void HidOutput::_setButtons(uint8_t buttons, int64_t source_us){
+    if(buttons == _buttons) return;
+    if(_transition_count >= HID_TRANSITION_MAX){
+        _transition_count--;
+        _dropped++;
+    }
+    _transitions[_transition_count] = buttons;
+    _transition_us[_transition_count] = source_us;
+    _transition_count++;
+    _buttons = buttons;
+}
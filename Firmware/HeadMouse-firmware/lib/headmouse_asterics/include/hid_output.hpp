@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+
+constexpr uint32_t HID_REPORT_INTERVAL_DEF_US = 7500;   // Minimum BLE connection interval, until the negotiated one is set
+constexpr uint32_t HID_TRANSITION_MAX = 8;              // Button transitions waiting for their own report
+#ifdef HM_HID_16BIT
+constexpr int32_t HID_DELTA_MAX = 32767;                // Largest movement of a report [counts], 16 bit signed X/Y
+#else
+constexpr int32_t HID_DELTA_MAX = 127;                  // Largest movement of a report [counts], 8 bit signed
+#endif
+constexpr int32_t HID_WHEEL_MAX = 127;                  // Largest wheel movement of a report [counts], always 8 bit
+constexpr uint32_t HID_SPLIT_REPORT_MAX = 3;            // Extra reports per connection interval for larger movements
+
+/*! *********************************************************
+* @brief Mouse report passed from the output stage to BLE.
+* @param source_us Time of the button event causing the button
+*        transition of the report [us], 0 if it has none.
+* @param buttons Mouse button state.
+* @param x Horizontal movement [counts] or position if absolute.
+* @param y Vertical movement [counts] or position if absolute.
+* @param wheel Wheel movement [counts].
+* @param pan Horizontal wheel movement [counts].
+* @param requests Movements and button transitions merged into
+*        the report.
+* @param is_split TRUE if the report carries the excess of a
+*        movement too large for one report.
+* @param is_absolute TRUE if x/y are an absolute position
+*        (0..ABS_POSITION_MAX).
+*************************************************************/
+struct HidReport {
+    int64_t source_us;
+    uint8_t buttons;
+    int32_t x;
+    int32_t y;
+    int32_t wheel;
+    int32_t pan;
+    uint32_t requests;
+    bool is_split;
+    bool is_absolute;
+};
+
+/*! *********************************************************
+* @brief Output stage coalescing mouse movements and buttons
+*        into at most one HID report per connection interval.
+*
+* Movements are summed until the next report. Every button 
+* transition gets its own report, so a click is never merged into
+* no change; pending movements ride with the oldest transition.
+* Movements beyond HID_DELTA_MAX are split: the excess follows in
+* up to HID_SPLIT_REPORT_MAX extra reports in the same connection
+* interval, anything left is carried into the next interval.
+* Absolute positions replace each other, the report type follows
+* the last movement. Must only be used by one task.
+*************************************************************/
+class HidOutput {
+    private:
+    int32_t _x = 0;
+    int32_t _y = 0;
+    int32_t _wheel = 0;
+    int32_t _pan = 0;
+    int32_t _abs_x = 0;                 // Absolute position, if _is_absolute
+    int32_t _abs_y = 0;
+    bool _is_absolute = false;
+    bool _is_abs_pending = false;       // Position not sent yet
+    uint32_t _move_requests = 0;        // Movements summed since the last report
+    uint8_t _buttons = 0;               // Button state after all pending transitions
+    uint8_t _sent_buttons = 0;          // Button state of the last report
+    uint8_t _transitions[HID_TRANSITION_MAX];   // Pending button states, oldest first
+    int64_t _transition_us[HID_TRANSITION_MAX];
+    uint32_t _transition_count = 0;
+    int64_t _last_report_us = 0;
+    uint32_t _interval_us = HID_REPORT_INTERVAL_DEF_US;
+    uint32_t _split_count = 0;          // Extra reports sent in the current interval
+    uint32_t _dropped = 0;
+
+    void _setButtons(uint8_t buttons, int64_t source_us);
+
+    public:
+    void setInterval(uint32_t interval_us);
+    uint32_t getInterval();
+    void move(int32_t x, int32_t y, int32_t wheel = 0, int32_t pan = 0);
+    bool moveTo(int32_t x, int32_t y);
+    bool isAbsolute();
+    void press(uint8_t b, int64_t source_us);
+    void release(uint8_t b, int64_t source_us);
+    void click(uint8_t b, int64_t source_us);
+    bool isPressed(uint8_t b);
+    bool isPending();
+    uint32_t getWaitMs(int64_t now_us, uint32_t timeout_ms);
+    bool popReport(int64_t now_us, HidReport* report);
+    void clear();
+    uint32_t getDropped();
+};
@@ -37,6 +37,14 @@ constexpr pin PIN_BNO55_INT = 13;
 /* BNO055 config */
 constexpr int32_t BNO055_SENSOR_ID = 55;
 constexpr uint8_t BNO055_I2C_ADDRESS = 0x28;
+constexpr uint8_t BNO055_QUAT_DATA_REG = 0x20;      /* QUA_Data_w_LSB, followed by w_MSB, x, y, z */
+constexpr uint8_t BNO055_PAGE_ID_REG = 0x07;
+constexpr uint8_t BNO055_INT_MSK_REG = 0x0F;        /* Page 1, config mode only: route interrupt to INT pin */
+constexpr uint8_t BNO055_INT_EN_REG = 0x10;         /* Page 1, config mode only: enable interrupt */
+constexpr uint8_t BNO055_SYS_TRIGGER_REG = 0x3F;
+constexpr uint8_t BNO055_INT_ACC_BSX_DRDY = 0x01;   /* Data ready of the fusion (BSX) accelerometer samples, 100 Hz in NDOF */
+constexpr uint8_t BNO055_RST_INT = 0x40;            /* SYS_TRIGGER: reset latched INT pin */
+constexpr uint32_t SAMPLE_INT_TIMEOUT_TICKS = 3;    /* Program cycle timer ticks without data ready before timer sampling takes over */
 
 /* Serial communication config */
 constexpr uint32_t SERIAL_BAUD_RATE = 115200;
@@ -44,7 +52,19 @@ constexpr uint32_t SERIAL_BAUD_RATE = 115200;
 /* BLE Device config */
 constexpr char DEVICE_NAME[] = "HeadMouse V1";
 constexpr char DEVICE_MANUFACTURER[] = "FH Technikum Wien";
-constexpr uint8_t BAT_LEVEL_DUMMY = 100;
+constexpr uint8_t BAT_LEVEL_DUMMY = 100;      /* Until init() has measured the battery */
+
+/* BLE connection parameters, intervals in 1.25 ms units, supervision timeout in 10 ms units */
+constexpr uint32_t BLE_CONN_INTERVAL_UNIT_US = 1250;
+constexpr uint32_t BLE_CONN_TIMEOUT_UNIT_MS = 10;
+constexpr uint16_t BLE_CONN_ACTIVE_INTERVAL_MIN = 6;    /* 7.5 ms while the head moves */
+constexpr uint16_t BLE_CONN_ACTIVE_INTERVAL_MAX = 12;   /* 15 ms */
+constexpr uint16_t BLE_CONN_ACTIVE_LATENCY = 0;
+constexpr uint16_t BLE_CONN_IDLE_INTERVAL_MIN = 24;     /* 30 ms while the head rests */
+constexpr uint16_t BLE_CONN_IDLE_INTERVAL_MAX = 40;     /* 50 ms */
+constexpr uint16_t BLE_CONN_IDLE_LATENCY = 4;           /* Connection events the HeadMouse may skip without data */
+constexpr uint16_t BLE_CONN_TIMEOUT = 400;              /* 4 s */
+constexpr uint32_t BLE_CONN_IDLE_DELAY_MS = 3000;       /* Time without movement before the idle parameters are requested */
 
 /* Program cycle duration */
 constexpr uint32_t PROGRAM_CYCLE_INTERVAL_MS = 10;
@@ -0,0 +1,140 @@
+#include <Arduino.h>
+#include "hm_task.hpp"
+#ifdef HM_HOST_BUILD
+#include <atomic>
+#include <chrono>
+#include <pthread.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+namespace{
+    std::vector<std::thread> _threads;      // Pipeline tasks, joined at exit
+    std::atomic<bool> _is_stopping{false};
+
+    /* Stop the tasks before static objects they use are destroyed */
+    void _stopTasks(){
+        _is_stopping = true;
+        for(std::thread& thread : _threads){
+            if(thread.joinable()) thread.join();
+        }
+    }
+}
+#else
+#include "freertos/task.h"
+#endif
+
+/* TASK SIGNAL ******************************************************/
+
+/************************************************************
+ * @brief Create the underlying synchronisation object.
+ *
+ * @return TRUE on success, FALSE otherwise.
+ *************************************************************/
+bool TaskSignal::init(){
+#ifdef HM_HOST_BUILD
+    return true;
+#else
+    if(_semaphore == nullptr) _semaphore = xSemaphoreCreateBinary();
+    return (_semaphore != nullptr);
+#endif
+}
+
+/************************************************************
+ * @brief Wake the waiting task (task context).
+ *************************************************************/
+void TaskSignal::give(){
+#ifdef HM_HOST_BUILD
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _is_given = true;
+    }
+    _condition.notify_one();
+#else
+    if(_semaphore != nullptr) xSemaphoreGive(_semaphore);
+#endif
+}
+
+/************************************************************
+ * @brief Wake the waiting task (interrupt context).
+ *
+ * Switches to the woken task at the end of the ISR if it has a
+ * higher priority than the interrupted one.
+ *************************************************************/
+void IRAM_ATTR TaskSignal::giveFromIsr(){
+#ifdef HM_HOST_BUILD
+    give();     // Host ISRs run on the simulation thread
+#else
+    BaseType_t is_woken = pdFALSE;
+    if(_semaphore != nullptr) xSemaphoreGiveFromISR(_semaphore, &is_woken);
+    if(is_woken == pdTRUE) portYIELD_FROM_ISR();
+#endif
+}
+
+/************************************************************
+ * @brief Wait for the signal.
+ *
+ * @param timeout_ms Maximum time to wait [ms].
+ * @return TRUE if the signal was given, FALSE on timeout.
+ *************************************************************/
+bool TaskSignal::take(uint32_t timeout_ms){
+#ifdef HM_HOST_BUILD
+    std::unique_lock<std::mutex> lock(_mutex);
+    if(!_condition.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]{ return _is_given; })) return false;
+    _is_given = false;
+    return true;
+#else
+    if(_semaphore == nullptr) return false;
+    return (xSemaphoreTake(_semaphore, pdMS_TO_TICKS(timeout_ms)) == pdTRUE);
+#endif
+}
+
+/* TASKS ************************************************************/
+
+/************************************************************
+ * @brief Start a task pinned to a core.
+ *
+ * On the host the task runs on a std::thread pinned to the same
+ * core number (modulo the host cores); the priority is ignored.
+ *
+ * @param name Task name.
+ * @param function Task function, must return once taskIsRunning()
+ *                 is FALSE.
+ * @param arg Argument of the task function.
+ * @param stack_size Stack size [bytes].
+ * @param priority FreeRTOS priority (higher runs first).
+ * @param core CPU core the task is pinned to.
+ * @return TRUE on success, FALSE otherwise.
+ *************************************************************/
+bool taskCreate(const char* name, TaskFunction function, void* arg, uint32_t stack_size, uint32_t priority, int core){
+#ifdef HM_HOST_BUILD
+    (void)name; (void)stack_size; (void)priority;
+    if(_threads.empty()) atexit(_stopTasks);
+    _threads.emplace_back(function, arg);
+
+    unsigned int host_cores = std::thread::hardware_concurrency();
+    if(host_cores > 0){
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(core % host_cores, &cpu_set);
+        pthread_setaffinity_np(_threads.back().native_handle(), sizeof(cpu_set), &cpu_set);    // Best effort
+    }
+    return true;
+#else
+    return (xTaskCreatePinnedToCore(function, name, stack_size, arg, priority, nullptr, core) == pdPASS);
+#endif
+}
+
+/************************************************************
+ * @brief Check if tasks shall keep running.
+ *
+ * @return FALSE on the host once the program exits, always TRUE
+ *         on the device.
+ *************************************************************/
+bool taskIsRunning(){
+#ifdef HM_HOST_BUILD
+    return !_is_stopping;
+#else
+    return true;
+#endif
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+#ifdef HM_HOST_BUILD
+#include <mutex>
+#include <condition_variable>
+#else
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#endif
+
+typedef void (*TaskFunction)(void*);
+
+/*! *********************************************************
+* @brief Binary signal to wake a waiting task.
+*
+* FreeRTOS binary semaphore on the device, mutex and condition
+* variable on the host. Signals given while the task is busy are
+* merged into one wakeup.
+*************************************************************/
+class TaskSignal {
+    private:
+#ifdef HM_HOST_BUILD
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _is_given = false;
+#else
+    SemaphoreHandle_t _semaphore = nullptr;
+#endif
+
+    public:
+    bool init();
+    void give();
+    void giveFromIsr();
+    bool take(uint32_t timeout_ms);
+};
+
+bool taskCreate(const char* name, TaskFunction function, void* arg, uint32_t stack_size, uint32_t priority, int core);
+bool taskIsRunning();
@@ -1,8 +1,19 @@
 #pragma once
-#include "ESP32TimerInterrupt.hpp"
+#include "tick_timer.hpp"
+#include "hm_board_config_v1_0.hpp"
+
+/* Tick period of the shared hardware timer (program cycle, button debounce and LED blink are multiples) */
+constexpr uint32_t TICK_INTERVAL_MS = PROGRAM_CYCLE_INTERVAL_MS;
+
+/*! *********************************************************
+* @brief Enum to define the channels of the tick timer
+*************************************************************/
+enum TickChannel {
+    TICK_PROGRAM_CYCLE,
+    TICK_BUTTONS,
+    TICK_LEDS
+};
 
 namespace isr{
-    extern ESP32Timer BtnTimer;             /* Timer 0 */ 
-    extern ESP32Timer LedBlinkTimer;        /* Timer 1 */ 
-    extern ESP32Timer ProgramCycleTimer;    /* Timer 2 */ 
+    extern TickTimer SystemTick;            /* Timer 0 */ 
 }
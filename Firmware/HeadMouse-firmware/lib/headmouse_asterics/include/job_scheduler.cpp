@@ -0,0 +1,137 @@
+#include <Arduino.h>
+#include "esp_timer.h"
+#include "job_scheduler.hpp"
+
+/* Sort key of the rate-monotonic order, triggered jobs last */
+static inline uint32_t _orderKey(uint32_t period_ticks){
+    return (period_ticks == JOB_ON_EVENT) ? UINT32_MAX : period_ticks;
+}
+
+/************************************************************
+ * @brief Add a job.
+ *
+ * @param name Job name (static string).
+ * @param period_ticks Release period [ticks], JOB_ON_EVENT if the
+ *                     job only runs when triggered.
+ * @param function Job function.
+ * @param context Argument of the job function.
+ * @return Job index (in order of adding), -1 if no job is left.
+ *************************************************************/
+int JobScheduler::addJob(const char* name, uint32_t period_ticks, JobFunction function, void* context){
+    if((_job_count >= SCHEDULER_JOB_MAX) || (function == nullptr)) return -1;
+
+    int index = _job_count++;
+    Job& job = _jobs[index];
+    job.function = function;
+    job.context = context;
+    job.next_release = 0;
+    job.is_triggered = false;
+    job.is_enabled = true;
+    job.stats = HmJobStats();
+    job.stats.name = name;
+    job.stats.period_ticks = period_ticks;
+
+    /* Insert into the rate-monotonic order, after jobs with the same period */
+    int pos = index;
+    while((pos > 0) && (_orderKey(_jobs[_order[pos-1]].stats.period_ticks) > _orderKey(period_ticks))){
+        _order[pos] = _order[pos-1];
+        pos--;
+    }
+    _order[pos] = (uint8_t)index;
+    return index;
+}
+
+/************************************************************
+ * @brief Request a run of a job with the next call of run().
+ *
+ * @param job Job index.
+ *************************************************************/
+void JobScheduler::trigger(int job){
+    if((job >= 0) && ((uint32_t)job < _job_count)) _jobs[job].is_triggered = true;
+}
+
+/************************************************************
+ * @brief Enable or disable a job.
+ *
+ * @param job Job index.
+ * @param is_enabled FALSE to skip the job until enabled again.
+ *************************************************************/
+void JobScheduler::setEnabled(int job, bool is_enabled){
+    if((job >= 0) && ((uint32_t)job < _job_count)) _jobs[job].is_enabled = is_enabled;
+}
+
+/************************************************************
+ * @brief Release all periodic jobs at the given tick.
+ *
+ * @param tick Current tick.
+ *************************************************************/
+void JobScheduler::start(uint32_t tick){
+    for(uint32_t i=0; i<_job_count; i++){
+        _jobs[i].next_release = tick;
+    }
+}
+
+/************************************************************
+ * @brief Run all due jobs.
+ *
+ * A periodic job runs once per call even if several of its
+ * releases are due; the skipped releases count as deadline misses.
+ *
+ * @param tick Current tick.
+ *************************************************************/
+void JobScheduler::run(uint32_t tick){
+    for(uint32_t i=0; i<_job_count; i++){
+        Job& job = _jobs[_order[i]];
+        uint32_t period = job.stats.period_ticks;
+        uint32_t lateness = 0;     // Ticks since the release being run
+
+        if(!job.is_enabled) continue;
+        if(period == JOB_ON_EVENT){
+            if(!job.is_triggered) continue;
+            job.is_triggered = false;
+        }
+        else{
+            if((int32_t)(tick - job.next_release) < 0) continue;
+            uint32_t skipped = (tick - job.next_release) / period;
+            lateness = (tick - job.next_release) - skipped * period;
+            job.stats.deadline_misses += skipped;
+            job.next_release += (skipped + 1) * period;
+        }
+
+        int64_t start_us = esp_timer_get_time();
+        job.function(job.context);
+        uint32_t run_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+        job.stats.runs++;
+        if(run_us > job.stats.run_max_us) job.stats.run_max_us = run_us;
+        if((period != JOB_ON_EVENT) && (((uint64_t)lateness * _tick_us + run_us) > (uint64_t)period * _tick_us)){
+            job.stats.deadline_misses++;
+        }
+    }
+}
+
+/************************************************************
+ * @brief Get the statistics of a job.
+ *
+ * @param job Job index.
+ * @return Job statistics, empty if the index is invalid.
+ *************************************************************/
+HmJobStats JobScheduler::getStats(int job){
+    if((job < 0) || ((uint32_t)job >= _job_count)) return HmJobStats();
+    return _jobs[job].stats;
+}
+
+uint32_t JobScheduler::getJobCount(){
+    return _job_count;
+}
+
+/************************************************************
+ * @brief Reset the run statistics of all jobs.
+ *************************************************************/
+void JobScheduler::resetStats(){
+    for(uint32_t i=0; i<_job_count; i++){
+        _jobs[i].stats.runs = 0;
+        _jobs[i].stats.deadline_misses = 0;
+        _jobs[i].stats.run_max_us = 0;
+    }
+}
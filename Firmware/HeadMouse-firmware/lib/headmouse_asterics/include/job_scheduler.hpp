@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+
+constexpr uint32_t SCHEDULER_JOB_MAX = 8;
+constexpr uint32_t JOB_ON_EVENT = 0;        // Period of jobs which only run when triggered
+
+typedef void (*JobFunction)(void* context);
+
+/*! *********************************************************
+* @brief Struct to store the statistics of a scheduler job.
+* @param name Job name.
+* @param period_ticks Release period [ticks], JOB_ON_EVENT for
+*        triggered jobs.
+* @param runs Number of runs.
+* @param deadline_misses Releases not finished within their period
+*        (including releases never run).
+* @param run_max_us Worst-case run time [us].
+*************************************************************/
+struct HmJobStats {
+    const char* name = "";
+    uint32_t period_ticks = 0;
+    uint32_t runs = 0;
+    uint32_t deadline_misses = 0;
+    uint32_t run_max_us = 0;
+};
+
+/*! *********************************************************
+* @brief Rate-monotonic scheduler of periodic and triggered jobs.
+*
+* Jobs are released on tick multiples of their period. Due jobs
+* run to completion in rate-monotonic order (shortest period
+* first), triggered jobs run last, so they see the results of the
+* periodic jobs of the same tick. A release which is not finished
+* within its period counts as a deadline miss.
+*************************************************************/
+class JobScheduler {
+    private:
+    struct Job {
+        JobFunction function;
+        void* context;
+        uint32_t next_release;      // Tick of the next release
+        bool is_triggered;
+        bool is_enabled;
+        HmJobStats stats;
+    };
+    Job _jobs[SCHEDULER_JOB_MAX];
+    uint8_t _order[SCHEDULER_JOB_MAX];  // Job indices in rate-monotonic order
+    uint32_t _job_count = 0;
+    uint32_t _tick_us;
+
+    public:
+    JobScheduler(uint32_t tick_us) : _tick_us(tick_us) {}
+    int addJob(const char* name, uint32_t period_ticks, JobFunction function, void* context);
+    void trigger(int job);
+    void setEnabled(int job, bool is_enabled);
+    void start(uint32_t tick);
+    void run(uint32_t tick);
+    HmJobStats getStats(int job);
+    uint32_t getJobCount();
+    void resetStats();
+};
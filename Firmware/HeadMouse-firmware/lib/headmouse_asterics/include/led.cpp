@@ -9,10 +9,8 @@ namespace led{
 }
 using namespace led;
 
+static_assert(LED_BLINK_INTERVAL_MS % TICK_INTERVAL_MS == 0, "LED blink interval must be a multiple of the tick");
 
-namespace isr{
-    ESP32Timer LedBlinkTimer(1);
-}
 using namespace isr;
 
 
@@ -44,18 +42,18 @@ Leds* Leds::getInstance(pin pin_status_g, pin pin_status_r, pin pin_battery_g, p
 /************************************************************
  * @brief Initialize the LEDs.
  *
- * This function initializes the LED pins and sets up the timer interrupt for LED blinking.
+ * This function initializes the LED pins and attaches the LED blinking channel of the tick timer.
  *
  * @return ERR_NONE if initialization is successful, otherwise ERR_GENERIC.
  *************************************************************/
 err Leds::  init(){
     err error = ERR_GENERIC;
-    for(int i=0; i<LED_COUNT; i++){
+    for(uint32_t i=0; i<LED_COUNT; i++){
         pinMode(_config[i].pin_r, OUTPUT);
         pinMode(_config[i].pin_g, OUTPUT);
     }
 
-    if (LedBlinkTimer.attachInterruptInterval(LED_BLINK_INTERVAL_MS * 1000, _callbackTimerLed)){
+    if (SystemTick.attachChannel(TICK_LEDS, LED_BLINK_INTERVAL_MS / TICK_INTERVAL_MS, _callbackTimerLed, true)){
         error = ERR_NONE;
     }
     else return ERR_GENERIC;
@@ -69,16 +67,18 @@ err Leds::  init(){
  * This function sets the state of the specified LED (battery 
  * or status) to the given state (e.g., RED, GREEN, ORANGE).
  * 
- * @note Blinking led states are handled in LED timer ISR.
+ * @note Blinking led states are handled in LED timer ISR. The
+ *       state is a single word written without locking; the ISR
+ *       also rewrites steady states, so pins written concurrently
+ *       by the ISR on the other core are corrected with the next
+ *       blink tick.
  *
  * @param led The type of LED (battery or status).
  * @param state The state to set the LED to (e.g., RED, GREEN, 
  *              ORANGE, BLINK_RED, BLINK_GREEN, BLINK_ORANGE).
  *************************************************************/
 void Leds::set(ledType led, ledState state){
-    LedBlinkTimer.disableTimer();   /* Enter critical section */
     _config[led].state = state;     /* Set LED-config */
-    LedBlinkTimer.enableTimer();    /* Exit critical section */
 
     /* Select led action (if not blinking)*/
     switch(_config[led].state){
@@ -103,15 +103,17 @@ void Leds::set(ledType led, ledState state){
 /************************************************************
  * @brief Timer callback function for LED blinking.
  *
- * This function is called by the timer interrupt to handle the blinking of LEDs.
+ * This function is called by the tick timer interrupt to handle the blinking of LEDs
+ * and refreshes the pins of steady LED states.
  *
- * @param timerNo The timer number (unused).
+ * @param channel The tick timer channel (unused).
  * @return Always returns true.
  *************************************************************/
-bool IRAM_ATTR Leds::_callbackTimerLed(void * timerNo){
+bool IRAM_ATTR Leds::_callbackTimerLed(void * channel){
+    (void)channel;
     static bool toggle[LED_COUNT] = {0};
 
-    for(int i=0; i<LED_COUNT; i++){
+    for(uint32_t i=0; i<LED_COUNT; i++){
         if(_config[i].state == BLINK_GREEN){
             digitalWrite(_config[i].pin_r, HIGH);  
             digitalWrite(_config[i].pin_g, toggle[i]); 
@@ -124,7 +126,18 @@ bool IRAM_ATTR Leds::_callbackTimerLed(void * timerNo){
             digitalWrite(_config[i].pin_r, toggle[i]);  
             digitalWrite(_config[i].pin_g, toggle[i]); 
         }
-        else {} /* Ignore if blinking is not intended */
+        else if(_config[i].state == GREEN){
+            digitalWrite(_config[i].pin_r, HIGH);  
+            digitalWrite(_config[i].pin_g, LOW); 
+        }
+        else if(_config[i].state == ORANGE){
+            digitalWrite(_config[i].pin_r, LOW);  
+            digitalWrite(_config[i].pin_g, LOW); 
+        }
+        else { /* RED */
+            digitalWrite(_config[i].pin_r, LOW);  
+            digitalWrite(_config[i].pin_g, HIGH); 
+        }
         
         toggle[i] = !toggle[i];
     }
@@ -0,0 +1,77 @@
+#include "motion_curve.hpp"
+
+/************************************************************
+ * @brief Convert a control point velocity.
+ *
+ * @param velocity Angular velocity [mRAD/s].
+ * @return Angular velocity [RAD/s]*2^MOTION_V_SHIFT.
+ *************************************************************/
+static int32_t _velocityToQ(uint16_t velocity){
+    return (int32_t)(((int64_t)velocity << MOTION_V_SHIFT) / 1000);
+}
+
+/************************************************************
+ * @brief Check a pointer acceleration curve.
+ *
+ * @param curve Curve to check.
+ * @return TRUE if the curve has 1..MOTION_CURVE_POINT_COUNT 
+ *         points with ascending velocity and gains up to 
+ *         MOTION_CURVE_GAIN_MAX.
+ *************************************************************/
+bool MotionCurveTable::isValid(const MotionCurve& curve){
+    if((curve.point_count < 1) || (curve.point_count > MOTION_CURVE_POINT_COUNT)) return false;
+
+    for(int i=0; i<curve.point_count; i++){
+        if(curve.points[i].gain > MOTION_CURVE_GAIN_MAX) return false;
+        if((i > 0) && (curve.points[i].velocity <= curve.points[i-1].velocity)) return false;
+    }
+    return true;
+}
+
+/************************************************************
+ * @brief Evaluate a pointer acceleration curve directly.
+ *
+ * @param curve Valid curve.
+ * @param velocity Absolute head angular velocity 
+ *                 [RAD/s]*2^MOTION_V_SHIFT.
+ * @return Gain [counts/RAD].
+ *************************************************************/
+int32_t MotionCurveTable::curveGain(const MotionCurve& curve, int32_t velocity){
+    const MotionCurvePoint* points = curve.points;
+
+    if(velocity <= _velocityToQ(points[0].velocity)) return points[0].gain;
+    for(int i=1; i<curve.point_count; i++){
+        int32_t x0 = _velocityToQ(points[i-1].velocity);
+        int32_t x1 = _velocityToQ(points[i].velocity);
+        if(velocity <= x1){
+            if(x1 == x0) return points[i].gain;
+            /* 64 bit: gain step times velocity span exceeds int32 for widely spaced points */
+            return points[i-1].gain + (int32_t)((((int64_t)points[i].gain - points[i-1].gain) * (velocity - x0)) / (x1 - x0));
+        }
+    }
+    return points[curve.point_count - 1].gain;
+}
+
+/************************************************************
+ * @brief Precompute a pointer acceleration curve.
+ *
+ * The velocity step of the lookup table is the smallest power of 
+ * two which spans the control points with MOTION_CURVE_LUT_SIZE
+ * entries.
+ *
+ * @param curve Curve to precompute.
+ * @return TRUE on success, FALSE if the curve is invalid (the
+ *         table is left unchanged).
+ *************************************************************/
+bool MotionCurveTable::build(const MotionCurve& curve){
+    if(!isValid(curve)) return false;
+
+    _x_max = _velocityToQ(curve.points[curve.point_count - 1].velocity);
+    _gain_max = curve.points[curve.point_count - 1].gain;
+    _step_shift = 0;
+    while((_x_max >> _step_shift) >= MOTION_CURVE_LUT_SIZE) _step_shift++;
+    for(int i=0; i<=MOTION_CURVE_LUT_SIZE; i++){
+        _lut[i] = curveGain(curve, (int32_t)i << _step_shift);
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "def_preferences.hpp"
+
+constexpr int MOTION_CURVE_LUT_SIZE = 128;      // Gain entries between zero velocity and the last control point
+
+/*! *********************************************************
+* @brief Precomputed pointer acceleration curve
+*
+* The curve is resampled into a gain lookup table with a power of
+* two velocity step, so that evaluating it is one indexed lookup
+* with linear interpolation, independent of the number of control
+* points.
+*************************************************************/
+class MotionCurveTable {
+    private:
+    int32_t _lut[MOTION_CURVE_LUT_SIZE + 1] = {0};    // [counts/RAD], one entry per 2^_step_shift of velocity
+    int _step_shift = 0;
+    int32_t _x_max = 0;         // Velocity of the last control point [RAD/s]*2^MOTION_V_SHIFT
+    int32_t _gain_max = 0;      // Gain at and above _x_max [counts/RAD]
+
+    public:
+    static bool isValid(const MotionCurve& curve);
+    static int32_t curveGain(const MotionCurve& curve, int32_t velocity);
+    bool build(const MotionCurve& curve);
+
+    /************************************************************
+     * @brief Get the gain of the curve.
+     *
+     * @param velocity Absolute head angular velocity 
+     *                 [RAD/s]*2^MOTION_V_SHIFT.
+     * @return Gain [counts/RAD].
+     *************************************************************/
+    inline int32_t gain(int32_t velocity) const {
+        if(velocity >= _x_max) return _gain_max;
+        int32_t index = velocity >> _step_shift;
+        int32_t fraction = velocity & (((int32_t)1 << _step_shift) - 1);
+        return _lut[index] + (int32_t)(((int64_t)(_lut[index+1] - _lut[index]) * fraction) >> _step_shift);
+    }
+};
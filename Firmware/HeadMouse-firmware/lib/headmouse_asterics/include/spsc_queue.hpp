@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+/*! *********************************************************
+* @brief Lock-free single-producer/single-consumer ring buffer.
+*
+* push() must only be called by one task or ISR and pop() by
+* one other task. Head and tail are free running counters, so all
+* SIZE slots can be used. SIZE must be a power of two.
+*************************************************************/
+template <typename T, uint32_t SIZE>
+class SpscQueue {
+    static_assert((SIZE != 0) && ((SIZE & (SIZE - 1)) == 0), "SpscQueue size must be a power of two");
+
+    private:
+    T _items[SIZE];
+    std::atomic<uint32_t> _head{0};     // Items pushed, only written by the producer
+    std::atomic<uint32_t> _tail{0};     // Items popped, only written by the consumer
+
+    public:
+    /************************************************************
+     * @brief Append an item (producer side).
+     *
+     * @param item Item to copy into the queue.
+     * @return TRUE on success, FALSE if the queue is full.
+     *************************************************************/
+    bool push(const T& item){
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if((head - _tail.load(std::memory_order_acquire)) >= SIZE) return false;
+
+        _items[head & (SIZE - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /************************************************************
+     * @brief Remove the oldest item (consumer side).
+     *
+     * @param item Output: oldest item.
+     * @return TRUE on success, FALSE if the queue is empty.
+     *************************************************************/
+    bool pop(T* item){
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if(tail == _head.load(std::memory_order_acquire)) return false;
+
+        *item = _items[tail & (SIZE - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+};
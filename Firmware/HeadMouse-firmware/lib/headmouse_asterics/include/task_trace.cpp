@@ -0,0 +1,127 @@
+#ifdef HM_TRACE_TASKS
+#include <Arduino.h>
+#include "task_trace.hpp"
+#ifdef HM_HOST_BUILD
+#include <chrono>
+#include <sched.h>
+#else
+#include "esp_timer.h"
+#include "esp_freertos_hooks.h"
+#endif
+
+namespace{
+    HmTaskTrace _trace;                                     // Only written by the motion task
+    int64_t _start_us = 0;                                  // Time of the last reset
+    volatile int64_t _signaled_us = 0;                      // Last motion signal of the sensor task
+    volatile int64_t _idle_last_us[TRACE_CORE_COUNT] = {0}; // Last idle hook call per core
+    volatile uint64_t _idle_us[TRACE_CORE_COUNT] = {0};     // Idle time per core
+
+#ifndef HM_HOST_BUILD
+    /* Add the time since the last call to the idle time, unless the idle task has been preempted in between */
+    inline void _idleTick(int core){
+        int64_t now_us = TaskTrace::now();
+        int64_t gap_us = now_us - _idle_last_us[core];
+
+        if(gap_us < TRACE_IDLE_GAP_US) _idle_us[core] += gap_us;
+        _idle_last_us[core] = now_us;
+    }
+
+    /* FALSE keeps the idle task polling, so gaps are short while the core is idle */
+    bool _idleHookCore0(){ _idleTick(0); return false; }
+    bool _idleHookCore1(){ _idleTick(1); return false; }
+#endif
+
+    int _currentCore(){
+#ifdef HM_HOST_BUILD
+        return sched_getcpu();
+#else
+        return xPortGetCoreID();
+#endif
+    }
+}
+
+/************************************************************
+ * @brief Register the idle hooks and start tracing.
+ *************************************************************/
+void TaskTrace::init(){
+#ifndef HM_HOST_BUILD
+    esp_register_freertos_idle_hook_for_cpu(_idleHookCore0, 0);
+    esp_register_freertos_idle_hook_for_cpu(_idleHookCore1, 1);
+#endif
+    reset();
+}
+
+/************************************************************
+ * @brief Clear the trace.
+ *************************************************************/
+void TaskTrace::reset(){
+    _trace = HmTaskTrace();
+    for(uint32_t i=0; i<TRACE_CORE_COUNT; i++){
+        _idle_us[i] = 0;
+    }
+    _start_us = now();
+}
+
+/************************************************************
+ * @brief Get the trace since the last reset.
+ *
+ * @return Task trace, core utilisation calculated up to now.
+ *************************************************************/
+HmTaskTrace TaskTrace::get(){
+    HmTaskTrace trace = _trace;
+
+#ifndef HM_HOST_BUILD
+    uint64_t elapsed_us = (uint64_t)(now() - _start_us);
+    for(uint32_t i=0; i<TRACE_CORE_COUNT; i++){
+        uint64_t idle_us = _idle_us[i];
+        if((elapsed_us > 0) && (idle_us <= elapsed_us)) trace.core_load[i] = (uint32_t)(1000 - (idle_us * 1000) / elapsed_us);
+    }
+#endif
+    return trace;
+}
+
+/************************************************************
+ * @brief Get the wall-clock time of the trace.
+ *
+ * The host uses the real clock, as the simulated clock does not
+ * advance while code runs.
+ *
+ * @return Time [us].
+ *************************************************************/
+int64_t TaskTrace::now(){
+#ifdef HM_HOST_BUILD
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    return esp_timer_get_time();
+#endif
+}
+
+/************************************************************
+ * @brief Hook of the sensor task, called when it signals the
+ *        motion task.
+ *************************************************************/
+void TaskTrace::motionSignaled(){
+    _signaled_us = now();
+}
+
+/************************************************************
+ * @brief Hook of the motion task, called at the end of a run.
+ *
+ * @param start_us Time the motion task woke up [us].
+ *************************************************************/
+void TaskTrace::motionRun(int64_t start_us){
+    int64_t end_us = now();
+    uint32_t run_us = (uint32_t)(end_us - start_us);
+    int64_t wake_us = start_us - _signaled_us;
+    int core = _currentCore();
+
+    _trace.motion_runs++;
+    if((core >= 0) && (core < 32)) _trace.motion_core_mask |= (1UL << core);
+    if(run_us > _trace.motion_run_max_us) _trace.motion_run_max_us = run_us;
+    if(run_us > TRACE_PREEMPT_THRESHOLD_US) _trace.motion_preempted++;
+    if(wake_us >= 0){
+        _trace.motion_wake_sum_us += wake_us;
+        if(wake_us > _trace.motion_wake_max_us) _trace.motion_wake_max_us = (uint32_t)wake_us;
+    }
+}
+#endif
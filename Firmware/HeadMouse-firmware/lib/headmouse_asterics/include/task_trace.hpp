@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+constexpr uint32_t TRACE_CORE_COUNT = 2;
+constexpr uint32_t TRACE_IDLE_GAP_US = 20;              // Longer gaps between two idle hook calls count as busy
+constexpr uint32_t TRACE_PREEMPT_THRESHOLD_US = 100;    // Motion runs taking longer have been preempted
+
+/*! *********************************************************
+* @brief Struct to store the task trace since the last reset.
+* @param core_load Utilisation per core [permille], 0 on the host.
+* @param motion_runs Number of motion task wakeups.
+* @param motion_core_mask Cores the motion task ran on (bit per core).
+* @param motion_preempted Motion runs longer than
+*        TRACE_PREEMPT_THRESHOLD_US.
+* @param motion_run_max_us Worst-case motion run time [us].
+* @param motion_wake_max_us Worst-case time from the sensor task
+*        signal until the motion task runs [us].
+* @param motion_wake_sum_us Sum of the wake times [us].
+*************************************************************/
+struct HmTaskTrace {
+    uint32_t core_load[TRACE_CORE_COUNT] = {0};
+    uint32_t motion_runs = 0;
+    uint32_t motion_core_mask = 0;
+    uint32_t motion_preempted = 0;
+    uint32_t motion_run_max_us = 0;
+    uint32_t motion_wake_max_us = 0;
+    uint64_t motion_wake_sum_us = 0;
+};
+
+/*! *********************************************************
+* @brief Tracing hooks of the task pipeline, compiled in with
+*        HM_TRACE_TASKS.
+*
+* Core utilisation is measured by a FreeRTOS idle hook per core.
+* While tracing, the hooks keep the idle tasks polling instead of
+* waiting for the next interrupt. Motion runs and wakeups are
+* timed in wall-clock time: a run that takes much longer than the
+* motion stage itself has been preempted.
+*************************************************************/
+class TaskTrace {
+    public:
+    static void init();
+    static void reset();
+    static HmTaskTrace get();
+    static int64_t now();
+    static void motionSignaled();
+    static void motionRun(int64_t start_us);
+};
@@ -0,0 +1,101 @@
+#include <Arduino.h>
+#include "tick_timer.hpp"
+
+TickTimer* TickTimer::_instance = nullptr;
+
+/************************************************************
+ * @brief Start the hardware timer.
+ *
+ * @param tick_us Tick period [us].
+ * @return TRUE on success (or if already started), FALSE otherwise.
+ *************************************************************/
+bool TickTimer::begin(uint32_t tick_us){
+    if(_instance == this) return true;
+    if(_instance != nullptr) return false;
+
+    _instance = this;
+    if(!_timer.attachInterruptInterval(tick_us, _callbackTimerTick)){
+        _instance = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/************************************************************
+ * @brief Attach a callback to a channel.
+ *
+ * @param channel Channel index.
+ * @param period_ticks Channel period [ticks].
+ * @param callback Function called in ISR context on every expiry,
+ *                 gets the channel index as argument.
+ * @param is_running TRUE to start the channel right away, FALSE
+ *                   to start it later with startChannel().
+ * @return TRUE on success, FALSE otherwise.
+ *************************************************************/
+bool TickTimer::attachChannel(int channel, uint32_t period_ticks, TickCallback callback, bool is_running){
+    if((channel < 0) || ((uint32_t)channel >= TICK_CHANNEL_MAX) || (period_ticks == 0) || (callback == nullptr)) return false;
+
+    Channel& ch = _channels[channel];
+    ch.is_running = false;
+    ch.callback = callback;
+    ch.period_ticks = period_ticks;
+    if(is_running) startChannel(channel);
+    return true;
+}
+
+/************************************************************
+ * @brief (Re)start a channel, safe to call from ISRs.
+ *
+ * The first expiry follows after at least one full period, no 
+ * matter where in the current tick the channel is started.
+ *
+ * @param channel Channel index.
+ *************************************************************/
+void IRAM_ATTR TickTimer::startChannel(int channel){
+    if((channel < 0) || ((uint32_t)channel >= TICK_CHANNEL_MAX)) return;
+
+    _channels[channel].remaining_ticks = _channels[channel].period_ticks + 1;
+    _channels[channel].is_running = true;
+}
+
+/************************************************************
+ * @brief Stop a channel, safe to call from ISRs (including the
+ *        channel's own callback).
+ *
+ * @param channel Channel index.
+ *************************************************************/
+void IRAM_ATTR TickTimer::stopChannel(int channel){
+    if((channel < 0) || ((uint32_t)channel >= TICK_CHANNEL_MAX)) return;
+
+    _channels[channel].is_running = false;
+}
+
+/************************************************************
+ * @brief Get the number of ticks since begin().
+ *
+ * @return Ticks (wrapping).
+ *************************************************************/
+uint32_t TickTimer::getTicks(){
+    return _ticks;
+}
+
+/************************************************************
+ * @brief Hardware timer callback, dispatches the expired channels.
+ *
+ * @param timerNo The timer number (unused).
+ * @return Always returns true.
+ *************************************************************/
+bool IRAM_ATTR TickTimer::_callbackTimerTick(void * timerNo){
+    (void)timerNo;
+    TickTimer* timer = _instance;
+
+    timer->_ticks++;
+    for(uint32_t i=0; i<TICK_CHANNEL_MAX; i++){
+        Channel& ch = timer->_channels[i];
+        if(!ch.is_running || (--ch.remaining_ticks > 0)) continue;
+
+        ch.remaining_ticks = ch.period_ticks;   /* Reload before the callback, which may stop or restart the channel */
+        ch.callback((void*)(uintptr_t)i);
+    }
+    return true;
+}
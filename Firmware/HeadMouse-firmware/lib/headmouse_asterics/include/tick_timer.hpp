@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+#include "ESP32TimerInterrupt.hpp"
+
+constexpr uint32_t TICK_CHANNEL_MAX = 4;
+
+typedef bool (*TickCallback)(void* channel);
+
+/*! *********************************************************
+* @brief Single hardware timer multiplexed into periodic channels.
+*
+* The hardware timer interrupts once per tick. Every running
+* channel counts its period down and calls its callback (in ISR
+* context) on expiry, so several periodic or restartable timeouts
+* share one timer and one interrupt. Only one instance may be
+* started.
+*************************************************************/
+class TickTimer {
+    private:
+    struct Channel {
+        TickCallback callback;
+        uint32_t period_ticks;
+        volatile uint32_t remaining_ticks;  // Ticks until the next expiry
+        volatile bool is_running;
+    };
+    ESP32Timer _timer;
+    Channel _channels[TICK_CHANNEL_MAX] = {};
+    volatile uint32_t _ticks = 0;
+
+    static TickTimer* _instance;
+
+    static bool _callbackTimerTick(void *);
+
+    public:
+    TickTimer(uint8_t timer_no) : _timer(timer_no) {}
+    bool begin(uint32_t tick_us);
+    bool attachChannel(int channel, uint32_t period_ticks, TickCallback callback, bool is_running);
+    void startChannel(int channel);
+    void stopChannel(int channel);
+    uint32_t getTicks();
+};
@@ -64,6 +64,20 @@ void log_message(LogLevel level, const char *format, ...) {
             break;
         #endif
 
+        #if LOG_LEVEL_TRACE_IMU
+        case LOG_TRACE_IMU:
+            Serial.print("\n[TRACE_IMU] ");
+            Serial.println(buffer);
+            break;
+        #endif
+
+        #if LOG_LEVEL_DEBUG_CYCLE
+        case LOG_DEBUG_CYCLE:
+            Serial.print("\n[DEBUG_CYCLE] ");
+            Serial.println(buffer);
+            break;
+        #endif
+
         #if LOG_LEVEL_INFO
         case LOG_INFO:
             Serial.print("\n[INFO] ");
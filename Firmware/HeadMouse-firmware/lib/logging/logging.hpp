@@ -7,6 +7,8 @@
 #define LOG_LEVEL_DEBUG     0        // General debug information excluding other debug keywords
 #define LOG_LEVEL_DEBUG_IMU 0      // IMU debug information only
 #define LOG_LEVEL_DEBUG_BAT 0     // Battery debug information only
+#define LOG_LEVEL_TRACE_IMU 0     // Raw IMU quaternion stream for host replay traces
+#define LOG_LEVEL_DEBUG_CYCLE 0   // Program cycle statistics only
 #define LOG_LEVEL_INFO      0
 #define LOG_LEVEL_WARNING   0
 #define LOG_LEVEL_ERROR     0
@@ -18,6 +20,8 @@ enum LogLevel {
     LOG_DEBUG,
     LOG_DEBUG_BAT,
     LOG_DEBUG_IMU,
+    LOG_TRACE_IMU,
+    LOG_DEBUG_CYCLE,
     LOG_INFO,
     LOG_WARNING,
     LOG_ERROR,
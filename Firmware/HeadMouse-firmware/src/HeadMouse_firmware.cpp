@@ -33,6 +33,9 @@ void setup() {
 
   log_message(LOG_INFO, "Starting setup...");
   error = hm.init(preferences);
+#ifndef HM_SINGLE_LOOP
+  if(error == ERR_NONE) error = hm.startTasks();
+#endif
   if(error == ERR_NONE)  log_message(LOG_INFO, "Setup done");
   else{
     log_message(LOG_ERROR, "Setup failed, error code: %d\n...", error);
@@ -43,9 +46,12 @@ void setup() {
 
 /* MAIN ******************************************************************/
 void loop() {
+#ifdef HM_SINGLE_LOOP
   if(hm.isMeasurementAvailable()){
-    hm.updateDevStatus();
-    hm.updateMovements();
-    hm.updateBtnActions();
+    hm.runJobs();
   }
+#else
+  /* Program cycles are run by the task pipeline */
+  delay(PROGRAM_CYCLE_INTERVAL_MS);
+#endif
 }
@@ -0,0 +1,93 @@
+/* BATTERY GAUGE TESTS ***************************************************
+ *
+ * Description: Battery charge estimation of BatteryGauge: lookup in
+ *              the discharge curve BAT_CURVE including its end points,
+ *              charging offset, filter and monotonic estimate.
+ *
+ *              Run: pio test -e native -f test_battery_gauge
+ *
+ ************************************************************************/
+#include <unity.h>
+#include "battery_gauge.hpp"
+
+void setUp(void){}
+void tearDown(void){}
+
+/* Voltages beyond the end points of the curve are full and empty */
+static void test_curve_end_points(void){
+    TEST_ASSERT_EQUAL_UINT8(100, BatteryGauge::percentOf(4200));
+    TEST_ASSERT_EQUAL_UINT8(100, BatteryGauge::percentOf(4350));
+    TEST_ASSERT_EQUAL_UINT8(99, BatteryGauge::percentOf(4190));
+    TEST_ASSERT_EQUAL_UINT8(0, BatteryGauge::percentOf(3300));
+    TEST_ASSERT_EQUAL_UINT8(0, BatteryGauge::percentOf(3000));
+    TEST_ASSERT_EQUAL_UINT8(0, BatteryGauge::percentOf(0));
+    TEST_ASSERT_EQUAL_UINT8(0, BatteryGauge::percentOf(3320));     // 0.33 %
+}
+
+/* Curve points are hit exactly, values in between are interpolated and rounded */
+static void test_curve_interpolation(void){
+    for(uint32_t i=0; i<BAT_CURVE_POINT_COUNT; i++){
+        TEST_ASSERT_EQUAL_UINT8(BAT_CURVE[i].percent, BatteryGauge::percentOf(BAT_CURVE[i].voltage_mv));
+    }
+    TEST_ASSERT_EQUAL_UINT8(95, BatteryGauge::percentOf(4150));
+    TEST_ASSERT_EQUAL_UINT8(55, BatteryGauge::percentOf(3850));
+    TEST_ASSERT_EQUAL_UINT8(3, BatteryGauge::percentOf(3450));     // 2.5 %
+
+    /* Never rises with falling voltage */
+    uint8_t previous = 100;
+    for(uint32_t mv=4300; mv>=3200; mv-=5){
+        uint8_t percent = BatteryGauge::percentOf(mv);
+        TEST_ASSERT_LESS_OR_EQUAL(previous, percent);
+        previous = percent;
+    }
+}
+
+/* The first measurement sets the estimate, the charge current offset is removed while charging */
+static void test_first_measurement_and_charge_offset(void){
+    BatteryGauge gauge;
+
+    TEST_ASSERT_EQUAL_UINT8(80, gauge.update(4000, false));
+    TEST_ASSERT_EQUAL_UINT32(4000, gauge.getVoltage());
+
+    gauge.reset();
+    TEST_ASSERT_EQUAL_UINT8(80, gauge.update(4000 + BAT_CHARGE_OFFSET_MV, true));
+    TEST_ASSERT_EQUAL_UINT32(4000, gauge.getVoltage());
+    TEST_ASSERT_EQUAL_UINT8(80, gauge.getPercent());
+}
+
+/* The estimate only falls while discharging and only rises while charging */
+static void test_monotonic_estimate(void){
+    BatteryGauge gauge;
+
+    TEST_ASSERT_EQUAL_UINT8(60, gauge.update(3870, false));
+    for(int i=0; i<100; i++) gauge.update(4000, false);
+    TEST_ASSERT_EQUAL_UINT8(60, gauge.getPercent());
+    for(int i=0; i<100; i++) gauge.update(3790, false);
+    TEST_ASSERT_EQUAL_UINT8(40, gauge.getPercent());
+
+    /* Plugging in sets the estimate once, then it can only rise */
+    TEST_ASSERT_EQUAL_UINT8(40, gauge.update(3790 + BAT_CHARGE_OFFSET_MV, true));
+    for(int i=0; i<100; i++) gauge.update(3700 + BAT_CHARGE_OFFSET_MV, true);
+    TEST_ASSERT_EQUAL_UINT8(40, gauge.getPercent());
+    for(int i=0; i<100; i++) gauge.update(4200 + BAT_CHARGE_OFFSET_MV, true);
+    TEST_ASSERT_EQUAL_UINT8(100, gauge.getPercent());
+}
+
+/* A single outlier moves the filtered voltage by 1/2^BAT_FILTER_SHIFT of its step */
+static void test_filter(void){
+    BatteryGauge gauge;
+
+    gauge.update(3800, false);
+    gauge.update(3800 - 160, false);
+    TEST_ASSERT_EQUAL_UINT32(3800 - (160 >> BAT_FILTER_SHIFT), gauge.getVoltage());
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_curve_end_points);
+    RUN_TEST(test_curve_interpolation);
+    RUN_TEST(test_first_measurement_and_charge_offset);
+    RUN_TEST(test_monotonic_estimate);
+    RUN_TEST(test_filter);
+    return UNITY_END();
+}
@@ -0,0 +1,92 @@
+/* CONNECTION PARAMETER TESTS ********************************************
+ *
+ * Description: Choice of the active/idle BLE connection profile by
+ *              head motion (ConnProfileSelector) and the connection
+ *              parameters of the BLE mouse across a reconnect.
+ *
+ *              Run: pio test -e native -f test_conn_profile
+ *
+ ************************************************************************/
+#include <unity.h>
+#include "conn_profile.hpp"
+#include "BleMouse.h"
+
+static constexpr int64_t TEST_T0_US = 1000000;
+static constexpr int64_t IDLE_DELAY_US = (int64_t)BLE_CONN_IDLE_DELAY_MS*1000;
+
+void setUp(void){}
+void tearDown(void){}
+
+/* Active on connecting, idle after the delay without movement, active again on the next one */
+static void test_active_idle_active(void){
+    ConnProfileSelector selector;
+
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_ACTIVE, selector.update(true, 0, TEST_T0_US));
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_NONE, selector.update(true, 0, TEST_T0_US + IDLE_DELAY_US - 1));
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_ACTIVE, selector.getProfile());
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_IDLE, selector.update(true, 0, TEST_T0_US + IDLE_DELAY_US));
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_NONE, selector.update(true, 0, TEST_T0_US + 2*IDLE_DELAY_US));
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_IDLE, selector.getProfile());
+
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_ACTIVE, selector.update(true, 1, TEST_T0_US + 3*IDLE_DELAY_US));
+}
+
+/* Every movement restarts the idle delay */
+static void test_movement_postpones_idle(void){
+    ConnProfileSelector selector;
+    int64_t now_us = TEST_T0_US;
+    uint32_t moves = 0;
+
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_ACTIVE, selector.update(true, moves, now_us));
+    for(int i=0; i<10; i++){
+        now_us += IDLE_DELAY_US / 2;
+        moves++;
+        TEST_ASSERT_EQUAL_INT(CONN_PROFILE_NONE, selector.update(true, moves, now_us));
+    }
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_NONE, selector.update(true, moves, now_us + IDLE_DELAY_US - 1));
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_IDLE, selector.update(true, moves, now_us + IDLE_DELAY_US));
+}
+
+/* Nothing is requested without a host, a reconnect starts active again */
+static void test_reconnect_starts_active(void){
+    ConnProfileSelector selector;
+
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_NONE, selector.update(false, 0, TEST_T0_US));
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_ACTIVE, selector.update(true, 0, TEST_T0_US));
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_IDLE, selector.update(true, 0, TEST_T0_US + IDLE_DELAY_US));
+
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_NONE, selector.update(false, 0, TEST_T0_US + 2*IDLE_DELAY_US));
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_NONE, selector.getProfile());
+    TEST_ASSERT_EQUAL_INT(CONN_PROFILE_ACTIVE, selector.update(true, 0, TEST_T0_US + 3*IDLE_DELAY_US));
+}
+
+/* Negotiated parameters of one host are not reported for the next one */
+static void test_disconnect_resets_params(void){
+    BleMouse mouse;
+
+    mouse.setHostIntervalMin(BLE_CONN_ACTIVE_INTERVAL_MIN);
+    mouse.setConnected(true);
+    mouse.requestConnParams(BLE_CONN_IDLE_INTERVAL_MIN, BLE_CONN_IDLE_INTERVAL_MAX, BLE_CONN_IDLE_LATENCY, BLE_CONN_TIMEOUT);
+    TEST_ASSERT_EQUAL_UINT16(BLE_CONN_IDLE_INTERVAL_MIN, mouse.getConnInterval());
+    TEST_ASSERT_EQUAL_UINT16(BLE_CONN_IDLE_LATENCY, mouse.getConnLatency());
+    TEST_ASSERT_EQUAL_UINT16(BLE_CONN_TIMEOUT, mouse.getConnTimeout());
+
+    mouse.setConnected(false);
+    TEST_ASSERT_EQUAL_UINT16(0, mouse.getConnInterval());
+    TEST_ASSERT_EQUAL_UINT16(0, mouse.getConnLatency());
+    TEST_ASSERT_EQUAL_UINT16(0, mouse.getConnTimeout());
+
+    /* The next host starts with its own parameters, without slave latency */
+    mouse.setConnected(true);
+    TEST_ASSERT_EQUAL_UINT16(BLE_CONN_ACTIVE_INTERVAL_MIN, mouse.getConnInterval());
+    TEST_ASSERT_EQUAL_UINT16(0, mouse.getConnLatency());
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_active_idle_active);
+    RUN_TEST(test_movement_postpones_idle);
+    RUN_TEST(test_reconnect_starts_active);
+    RUN_TEST(test_disconnect_resets_params);
+    return UNITY_END();
+}
@@ -0,0 +1,162 @@
+/* GESTURE RECOGNITION TESTS *********************************************
+ *
+ * Description: Feeds simulated button edges for click, double, triple,
+ *              long press and chord click into GestureFsm under several
+ *              hold/multi-click windows, including edges just inside and
+ *              just outside of them, and checks the recognised gestures
+ *              and the time completing each one.
+ *
+ *              Run: pio test -e native -f test_gesture
+ *
+ ************************************************************************/
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "gesture.hpp"
+
+static constexpr uint16_t TEST_TIMING_MS[][2] = {{GESTURE_HOLD_DEF_MS, GESTURE_GAP_DEF_MS}, {400, 120}, {60, 60}};  // hold/gap
+static constexpr int64_t TEST_T0_US = 1000000;     // Away from the zero timestamps of the reset state
+
+/*! *********************************************************
+* @brief Simulated button edge of a gesture scenario
+*************************************************************/
+struct GestureStep {
+    int64_t t_us;
+    uint8_t button;
+    BtnEventType type;
+};
+
+/*! *********************************************************
+* @brief Gesture scenario: button edges and the gestures
+*        expected from them, with the time completing each one
+*************************************************************/
+struct GestureScenario {
+    const char* name;
+    std::vector<GestureStep> steps;
+    std::vector<GestureOutput> expected;
+};
+
+/************************************************************
+ * @brief Gesture scenarios of a timing config.
+ *
+ * Button 0 maps all gestures and waits for multi-clicks, button 1
+ * maps click and long press only. Edge times are derived from the
+ * hold and gap windows, including edges just inside and just
+ * outside of them.
+ *
+ * @param hold_ms Hold window [ms].
+ * @param gap_ms Multi-click window [ms].
+ * @return Scenarios.
+ *************************************************************/
+static std::vector<GestureScenario> _gestureScenarios(uint16_t hold_ms, uint16_t gap_ms){
+    const int64_t h = (int64_t)hold_ms*1000;
+    const int64_t g = (int64_t)gap_ms*1000;
+    const int64_t margin = 1000;
+
+    return {
+        {"click", {{0, 0, BTN_DOWN}, {h/2, 0, BTN_UP}},
+                  {{h/2 + g, 0, GESTURE_CLICK, true}}},
+        {"click-hold-edge", {{0, 0, BTN_DOWN}, {h - margin, 0, BTN_UP}},
+                            {{h - margin + g, 0, GESTURE_CLICK, true}}},
+        {"click-no-multi", {{0, 1, BTN_DOWN}, {h/2, 1, BTN_UP}},
+                           {{h/2, 1, GESTURE_CLICK, true}}},
+        {"bounce", {{0, 0, BTN_DOWN}, {GESTURE_PUSH_MIN_US/2, 0, BTN_UP}},
+                   {}},
+        {"long-press", {{0, 0, BTN_DOWN}, {2*h, 0, BTN_UP}},
+                       {{h, 0, GESTURE_LONG_PRESS, true}, {2*h, 0, GESTURE_LONG_PRESS, false}}},
+        {"double-click", {{0, 0, BTN_DOWN}, {h/2, 0, BTN_UP}, {h/2 + g - margin, 0, BTN_DOWN}, {h + g - margin, 0, BTN_UP}},
+                         {{h + 2*g - margin, 0, GESTURE_DOUBLE_CLICK, true}}},
+        {"gap-exceeded", {{0, 0, BTN_DOWN}, {h/2, 0, BTN_UP}, {h/2 + g + margin, 0, BTN_DOWN}, {h + g + margin, 0, BTN_UP}},
+                         {{h/2 + g, 0, GESTURE_CLICK, true}, {h + 2*g + margin, 0, GESTURE_CLICK, true}}},
+        {"triple-click", {{0, 0, BTN_DOWN}, {h/2, 0, BTN_UP}, {h/2 + g/2, 0, BTN_DOWN}, {h + g/2, 0, BTN_UP},
+                          {h + g, 0, BTN_DOWN}, {3*h/2 + g, 0, BTN_UP}},
+                         {{3*h/2 + g, 0, GESTURE_TRIPLE_CLICK, true}}},
+        {"click-long-press", {{0, 0, BTN_DOWN}, {h/2, 0, BTN_UP}, {h/2 + g/2, 0, BTN_DOWN}, {3*h, 0, BTN_UP}},
+                             {{h/2 + g/2 + h, 0, GESTURE_CLICK, true}, {h/2 + g/2 + h, 0, GESTURE_LONG_PRESS, true},
+                              {3*h, 0, GESTURE_LONG_PRESS, false}}},
+        {"chord-click", {{0, 1, BTN_DOWN}, {margin, 0, BTN_DOWN}, {h/2 + margin, 0, BTN_UP}, {3*h/4, 1, BTN_UP}},
+                        {{h/2 + margin, 0, GESTURE_CHORD_CLICK, true}}}
+    };
+}
+
+/************************************************************
+ * @brief Replay a scenario under every timing config and compare
+ *        the recognised gestures, including the time completing
+ *        them, to the expected ones.
+ *
+ * @param name Scenario name.
+ *************************************************************/
+static void _checkScenario(const char* name){
+    bool is_found = false;
+
+    for(const auto& timing : TEST_TIMING_MS){
+        GestureConfig config;
+        config.hold_ms = timing[0];
+        config.gap_ms = timing[1];
+        config.actions[0][GESTURE_CLICK] = LEFT;
+        config.actions[0][GESTURE_DOUBLE_CLICK] = RIGHT;
+        config.actions[0][GESTURE_TRIPLE_CLICK] = SENSITIVITY;
+        config.actions[0][GESTURE_LONG_PRESS] = LEFT;
+        config.actions[0][GESTURE_CHORD_CLICK] = RIGHT;
+        config.actions[1][GESTURE_CLICK] = RIGHT;
+        config.actions[1][GESTURE_LONG_PRESS] = RIGHT;
+
+        for(const GestureScenario& scenario : _gestureScenarios(config.hold_ms, config.gap_ms)){
+            if(strcmp(scenario.name, name) != 0) continue;
+
+            GestureFsm fsm;
+            GestureOutput gesture;
+            std::vector<GestureOutput> got;
+            char message[64];
+
+            is_found = true;
+            snprintf(message, sizeof(message), "%s hold %u ms gap %u ms", name, config.hold_ms, config.gap_ms);
+            fsm.setConfig(config);
+            for(const GestureStep& step : scenario.steps){
+                fsm.handleEvent({TEST_T0_US + step.t_us, step.button, step.type});
+            }
+            fsm.update(TEST_T0_US + scenario.steps.back().t_us + 2*((int64_t)config.hold_ms + config.gap_ms)*1000);
+            while(fsm.popGesture(&gesture)) got.push_back(gesture);
+
+            TEST_ASSERT_EQUAL_UINT_MESSAGE(scenario.expected.size(), got.size(), message);
+            for(size_t i=0; i<got.size(); i++){
+                const GestureOutput& e = scenario.expected[i];
+                TEST_ASSERT_EQUAL_INT64_MESSAGE(TEST_T0_US + e.timestamp_us, got[i].timestamp_us, message);
+                TEST_ASSERT_EQUAL_UINT8_MESSAGE(e.button, got[i].button, message);
+                TEST_ASSERT_EQUAL_INT_MESSAGE(e.gesture, got[i].gesture, message);
+                TEST_ASSERT_EQUAL_INT_MESSAGE(e.is_start, got[i].is_start, message);
+            }
+        }
+    }
+    TEST_ASSERT_TRUE_MESSAGE(is_found, name);
+}
+
+void setUp(void){}
+void tearDown(void){}
+
+static void test_click(void){ _checkScenario("click"); }
+static void test_click_hold_edge(void){ _checkScenario("click-hold-edge"); }
+static void test_click_no_multi(void){ _checkScenario("click-no-multi"); }
+static void test_bounce(void){ _checkScenario("bounce"); }
+static void test_long_press(void){ _checkScenario("long-press"); }
+static void test_double_click(void){ _checkScenario("double-click"); }
+static void test_gap_exceeded(void){ _checkScenario("gap-exceeded"); }
+static void test_triple_click(void){ _checkScenario("triple-click"); }
+static void test_click_long_press(void){ _checkScenario("click-long-press"); }
+static void test_chord_click(void){ _checkScenario("chord-click"); }
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_click);
+    RUN_TEST(test_click_hold_edge);
+    RUN_TEST(test_click_no_multi);
+    RUN_TEST(test_bounce);
+    RUN_TEST(test_long_press);
+    RUN_TEST(test_double_click);
+    RUN_TEST(test_gap_exceeded);
+    RUN_TEST(test_triple_click);
+    RUN_TEST(test_click_long_press);
+    RUN_TEST(test_chord_click);
+    return UNITY_END();
+}
@@ -0,0 +1,167 @@
+/* HID OUTPUT TESTS ******************************************************
+ *
+ * Description: Output stage between the motion/button stages and BLE:
+ *              coalescing into one report per connection interval and
+ *              movements beyond the HID range.
+ *
+ *              Run: pio test -e native -f test_hid_output
+ *
+ ************************************************************************/
+#include <unity.h>
+#include "hid_output.hpp"
+#include "BleMouse.h"
+
+static constexpr uint32_t TEST_INTERVAL_US = 15000;
+static constexpr int64_t TEST_T0_US = 1000000;
+
+static HidOutput output;
+
+void setUp(void){
+    output = HidOutput();
+    output.setInterval(TEST_INTERVAL_US);
+}
+void tearDown(void){}
+
+/* Movements within one connection interval are summed into one report */
+static void test_moves_coalesced_per_interval(void){
+    HidReport report;
+
+    for(int i=0; i<5; i++) output.move(3, -2);
+    TEST_ASSERT_TRUE(output.popReport(TEST_T0_US, &report));
+    TEST_ASSERT_EQUAL_INT32(15, report.x);
+    TEST_ASSERT_EQUAL_INT32(-10, report.y);
+    TEST_ASSERT_EQUAL_UINT32(5, report.requests);
+    TEST_ASSERT_FALSE(report.is_split);
+    TEST_ASSERT_FALSE(output.popReport(TEST_T0_US, &report));
+
+    /* New movements wait for the next interval */
+    output.move(1, 1);
+    output.move(1, 1);
+    TEST_ASSERT_FALSE(output.popReport(TEST_T0_US + TEST_INTERVAL_US - 1, &report));
+    TEST_ASSERT_EQUAL_UINT32(1, output.getWaitMs(TEST_T0_US + TEST_INTERVAL_US - 1, 100));
+    TEST_ASSERT_TRUE(output.popReport(TEST_T0_US + TEST_INTERVAL_US, &report));
+    TEST_ASSERT_EQUAL_INT32(2, report.x);
+    TEST_ASSERT_EQUAL_INT32(2, report.y);
+    TEST_ASSERT_EQUAL_UINT32(2, report.requests);
+    TEST_ASSERT_FALSE(output.isPending());
+}
+
+/* Coalesced sums beyond the HID range never leave the range or flip their sign */
+static void test_coalesced_sum_not_wrapped(void){
+    HidReport report;
+    int64_t now_us = TEST_T0_US;
+    int32_t sum_x = 0, sum_y = 0;
+
+    for(int i=0; i<40; i++) output.move(100, -90);
+    while(output.isPending()){
+        while(output.popReport(now_us, &report)){
+            TEST_ASSERT_TRUE((report.x >= 0) && (report.x <= HID_DELTA_MAX));
+            TEST_ASSERT_TRUE((report.y <= 0) && (report.y >= -HID_DELTA_MAX));
+            sum_x += report.x;
+            sum_y += report.y;
+        }
+        now_us += TEST_INTERVAL_US;
+    }
+    TEST_ASSERT_EQUAL_INT32(4000, sum_x);
+    TEST_ASSERT_EQUAL_INT32(-3600, sum_y);
+}
+
+/* Wheel movements are limited to their 8 bit field independent of the X/Y size */
+static void test_wheel_not_wrapped(void){
+    HidReport report;
+
+    output.move(0, 0, 200, -300);
+    TEST_ASSERT_TRUE(output.popReport(TEST_T0_US, &report));
+    TEST_ASSERT_EQUAL_INT32(HID_WHEEL_MAX, report.wheel);
+    TEST_ASSERT_EQUAL_INT32(-HID_WHEEL_MAX, report.pan);
+}
+
+/* A movement beyond the HID range is split, button transitions keep their order around the split reports */
+static void test_split_keeps_button_order(void){
+    HidReport report;
+
+    output.move(2*HID_DELTA_MAX + 46, -HID_DELTA_MAX - 73);
+    output.press(MOUSE_LEFT, 10);
+    output.release(MOUSE_LEFT, 20);
+
+    /* Press rides with the first part of the movement */
+    TEST_ASSERT_TRUE(output.popReport(TEST_T0_US, &report));
+    TEST_ASSERT_FALSE(report.is_split);
+    TEST_ASSERT_EQUAL_UINT8(MOUSE_LEFT, report.buttons);
+    TEST_ASSERT_EQUAL_INT64(10, report.source_us);
+    TEST_ASSERT_EQUAL_INT32(HID_DELTA_MAX, report.x);
+    TEST_ASSERT_EQUAL_INT32(-HID_DELTA_MAX, report.y);
+
+    /* Excess follows in the same interval, still pressed */
+    TEST_ASSERT_TRUE(output.popReport(TEST_T0_US, &report));
+    TEST_ASSERT_TRUE(report.is_split);
+    TEST_ASSERT_EQUAL_UINT8(MOUSE_LEFT, report.buttons);
+    TEST_ASSERT_EQUAL_INT64(0, report.source_us);
+    TEST_ASSERT_EQUAL_INT32(HID_DELTA_MAX, report.x);
+    TEST_ASSERT_EQUAL_INT32(-73, report.y);
+    TEST_ASSERT_TRUE(output.popReport(TEST_T0_US, &report));
+    TEST_ASSERT_TRUE(report.is_split);
+    TEST_ASSERT_EQUAL_UINT8(MOUSE_LEFT, report.buttons);
+    TEST_ASSERT_EQUAL_INT32(46, report.x);
+    TEST_ASSERT_EQUAL_INT32(0, report.y);
+    TEST_ASSERT_FALSE(output.popReport(TEST_T0_US, &report));
+
+    /* Release gets its own report in the next interval */
+    TEST_ASSERT_TRUE(output.popReport(TEST_T0_US + TEST_INTERVAL_US, &report));
+    TEST_ASSERT_FALSE(report.is_split);
+    TEST_ASSERT_EQUAL_UINT8(0, report.buttons);
+    TEST_ASSERT_EQUAL_INT64(20, report.source_us);
+    TEST_ASSERT_EQUAL_INT32(0, report.x);
+    TEST_ASSERT_EQUAL_INT32(0, report.y);
+    TEST_ASSERT_FALSE(output.isPending());
+}
+
+/* Beyond HID_SPLIT_REPORT_MAX extra reports the rest is carried into the next interval */
+static void test_split_carries_rest(void){
+    HidReport report;
+    uint32_t count = 0;
+
+    output.move(6*HID_DELTA_MAX, 0);
+    while(output.popReport(TEST_T0_US, &report)){
+        TEST_ASSERT_EQUAL_INT32(HID_DELTA_MAX, report.x);
+        count++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(1 + HID_SPLIT_REPORT_MAX, count);
+    TEST_ASSERT_TRUE(output.isPending());
+
+    TEST_ASSERT_TRUE(output.popReport(TEST_T0_US + TEST_INTERVAL_US, &report));
+    TEST_ASSERT_FALSE(report.is_split);
+    TEST_ASSERT_EQUAL_INT32(HID_DELTA_MAX, report.x);
+    TEST_ASSERT_TRUE(output.popReport(TEST_T0_US + TEST_INTERVAL_US, &report));
+    TEST_ASSERT_TRUE(report.is_split);
+    TEST_ASSERT_EQUAL_INT32(HID_DELTA_MAX, report.x);
+    TEST_ASSERT_FALSE(output.isPending());
+}
+
+/* The BLE mouse saturates X/Y it cannot represent instead of wrapping */
+static void test_ble_report_saturated(void){
+    BleMouse mouse;
+    const uint8_t* sent = mouse.getLastReport();
+
+    mouse.setConnected(true);
+    mouse.report(MOUSE_LEFT, 300, -300);
+    TEST_ASSERT_EQUAL_UINT8(MOUSE_LEFT, sent[0]);
+#ifdef HM_HID_16BIT
+    TEST_ASSERT_EQUAL_INT16(300, (int16_t)(sent[1] | (sent[2] << 8)));
+    TEST_ASSERT_EQUAL_INT16(-300, (int16_t)(sent[3] | (sent[4] << 8)));
+#else
+    TEST_ASSERT_EQUAL_INT8(127, (int8_t)sent[1]);
+    TEST_ASSERT_EQUAL_INT8(-127, (int8_t)sent[2]);
+#endif
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_moves_coalesced_per_interval);
+    RUN_TEST(test_coalesced_sum_not_wrapped);
+    RUN_TEST(test_wheel_not_wrapped);
+    RUN_TEST(test_split_keeps_button_order);
+    RUN_TEST(test_split_carries_rest);
+    RUN_TEST(test_ble_report_saturated);
+    return UNITY_END();
+}
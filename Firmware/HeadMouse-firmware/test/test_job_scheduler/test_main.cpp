@@ -0,0 +1,154 @@
+/* JOB SCHEDULER TESTS ***************************************************
+ *
+ * Description: Rate-monotonic order, releases and deadline miss
+ *              accounting of the housekeeping JobScheduler. Job run
+ *              times are simulated by advancing the host clock.
+ *
+ *              Run: pio test -e native -f test_job_scheduler
+ *
+ ************************************************************************/
+#include <unity.h>
+#include "job_scheduler.hpp"
+#include "host_sim.h"
+
+static constexpr uint32_t TEST_TICK_US = 10000;
+
+/*! *********************************************************
+* @brief Test job: records its runs and takes run_us of
+*        simulated time
+*************************************************************/
+struct TestJob {
+    char id;
+    uint32_t run_us;
+    uint32_t runs;
+};
+
+static char run_order[16];
+static uint32_t run_order_count;
+
+static void _testJob(void* context){
+    TestJob* job = (TestJob*)context;
+    if(run_order_count < sizeof(run_order) - 1) run_order[run_order_count++] = job->id;
+    job->runs++;
+    host::advanceMicros(job->run_us);
+}
+
+void setUp(void){
+    host::resetTime();
+    run_order_count = 0;
+    for(char& c : run_order) c = 0;
+}
+void tearDown(void){}
+
+/* Shortest period first, triggered jobs after the periodic ones */
+static void test_rate_monotonic_order(void){
+    JobScheduler scheduler(TEST_TICK_US);
+    TestJob slow = {'s', 0, 0}, event = {'e', 0, 0}, fast = {'f', 0, 0}, fast2 = {'g', 0, 0};
+
+    TEST_ASSERT_EQUAL_INT(0, scheduler.addJob("slow", 10, _testJob, &slow));
+    TEST_ASSERT_EQUAL_INT(1, scheduler.addJob("event", JOB_ON_EVENT, _testJob, &event));
+    TEST_ASSERT_EQUAL_INT(2, scheduler.addJob("fast", 2, _testJob, &fast));
+    TEST_ASSERT_EQUAL_INT(3, scheduler.addJob("fast2", 2, _testJob, &fast2));
+    scheduler.start(0);
+    scheduler.trigger(1);
+    scheduler.run(0);
+    TEST_ASSERT_EQUAL_STRING("fgse", run_order);
+
+    /* Only the fast jobs are due, the event job is not triggered */
+    run_order_count = 0;
+    for(char& c : run_order) c = 0;
+    scheduler.run(2);
+    TEST_ASSERT_EQUAL_STRING("fg", run_order);
+    scheduler.run(3);
+    TEST_ASSERT_EQUAL_STRING("fg", run_order);
+}
+
+/* A run exceeding the period of its job is a deadline miss */
+static void test_overrun_is_deadline_miss(void){
+    JobScheduler scheduler(TEST_TICK_US);
+    TestJob job = {'j', 2*TEST_TICK_US, 0};
+    int index = scheduler.addJob("job", 2, _testJob, &job);
+
+    scheduler.start(0);
+    scheduler.run(0);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(index).deadline_misses);
+
+    job.run_us = 2*TEST_TICK_US + 1;
+    scheduler.run(2);
+    HmJobStats stats = scheduler.getStats(index);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.deadline_misses);
+    TEST_ASSERT_EQUAL_UINT32(2*TEST_TICK_US + 1, stats.run_max_us);
+}
+
+/* Releases never run count as misses, a late run counts its lateness */
+static void test_skipped_releases_are_deadline_misses(void){
+    JobScheduler scheduler(TEST_TICK_US);
+    TestJob job = {'j', 0, 0};
+    int index = scheduler.addJob("job", 2, _testJob, &job);
+
+    scheduler.start(0);
+    scheduler.run(0);
+    /* Releases at 2, 4 and 6 are due: 2 and 4 are skipped, 6 runs 1 tick late */
+    scheduler.run(7);
+    HmJobStats stats = scheduler.getStats(index);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.deadline_misses);
+
+    /* Next release at 8: 1 tick late plus a run time of more than 1 tick misses it */
+    job.run_us = TEST_TICK_US + 1;
+    scheduler.run(9);
+    stats = scheduler.getStats(index);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.deadline_misses);
+
+    scheduler.resetStats();
+    stats = scheduler.getStats(index);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.deadline_misses);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.run_max_us);
+}
+
+/* Triggered jobs run once per trigger and never miss a deadline, disabled jobs are skipped */
+static void test_triggered_and_disabled_jobs(void){
+    JobScheduler scheduler(TEST_TICK_US);
+    TestJob event = {'e', 5*TEST_TICK_US, 0}, periodic = {'p', 0, 0};
+    int event_index = scheduler.addJob("event", JOB_ON_EVENT, _testJob, &event);
+    int periodic_index = scheduler.addJob("periodic", 1, _testJob, &periodic);
+
+    scheduler.start(0);
+    scheduler.setEnabled(periodic_index, false);
+    scheduler.trigger(event_index);
+    scheduler.trigger(event_index);
+    scheduler.run(0);
+    scheduler.run(1);
+    TEST_ASSERT_EQUAL_UINT32(1, event.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, periodic.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(event_index).deadline_misses);
+
+    scheduler.setEnabled(periodic_index, true);
+    scheduler.run(2);
+    TEST_ASSERT_EQUAL_UINT32(1, periodic.runs);
+}
+
+static void test_job_limit(void){
+    JobScheduler scheduler(TEST_TICK_US);
+    TestJob job = {'j', 0, 0};
+
+    for(uint32_t i=0; i<SCHEDULER_JOB_MAX; i++){
+        TEST_ASSERT_EQUAL_INT((int)i, scheduler.addJob("job", 1, _testJob, &job));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, scheduler.addJob("job", 1, _testJob, &job));
+    TEST_ASSERT_EQUAL_UINT32(SCHEDULER_JOB_MAX, scheduler.getJobCount());
+    TEST_ASSERT_EQUAL_STRING("", scheduler.getStats(SCHEDULER_JOB_MAX).name);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_rate_monotonic_order);
+    RUN_TEST(test_overrun_is_deadline_miss);
+    RUN_TEST(test_skipped_releases_are_deadline_misses);
+    RUN_TEST(test_triggered_and_disabled_jobs);
+    RUN_TEST(test_job_limit);
+    return UNITY_END();
+}
@@ -0,0 +1,87 @@
+/* MOTION CURVE TESTS ****************************************************
+ *
+ * Description: Pointer acceleration curves: validation, interpolation
+ *              between control points and the precomputed gain lookup
+ *              table of MotionCurveTable.
+ *
+ *              Run: pio test -e native -f test_motion_curve
+ *
+ ************************************************************************/
+#include <unity.h>
+#include "motion_curve.hpp"
+
+static constexpr int32_t V_ONE = (int32_t)1 << MOTION_V_SHIFT;     // 1 rad/s
+
+void setUp(void){}
+void tearDown(void){}
+
+/* Direct evaluation and lookup table must agree, interpolation between widely spaced points must not overflow */
+static void test_wide_points_interpolate(void){
+    MotionCurve curve = {2, {{100, 0}, {10000, 8000}}};
+    MotionCurveTable table;
+
+    TEST_ASSERT_TRUE(MotionCurveTable::isValid(curve));
+    TEST_ASSERT_TRUE(table.build(curve));
+    /* 8000 * (v - 0.1) / 9.9 */
+    TEST_ASSERT_INT_WITHIN(1, 3959, MotionCurveTable::curveGain(curve, 5*V_ONE));
+    TEST_ASSERT_INT_WITHIN(1, 6384, MotionCurveTable::curveGain(curve, 8*V_ONE));
+    TEST_ASSERT_INT_WITHIN(2, 3959, table.gain(5*V_ONE));
+    TEST_ASSERT_INT_WITHIN(2, 6384, table.gain(8*V_ONE));
+}
+
+static void test_wide_points_monotonic(void){
+    MotionCurve curve = {2, {{100, 0}, {10000, 8000}}};
+    MotionCurveTable table;
+    int32_t previous = 0;
+
+    TEST_ASSERT_TRUE(table.build(curve));
+    for(int32_t v=0; v<=11*V_ONE; v+=V_ONE/64){
+        int32_t gain = table.gain(v);
+        TEST_ASSERT_GREATER_OR_EQUAL(previous, gain);
+        TEST_ASSERT_LESS_OR_EQUAL(8000, gain);
+        previous = gain;
+    }
+}
+
+static void test_gain_constant_outside_points(void){
+    MotionCurve curve = {3, {{300, 50}, {1500, 80}, {3000, 110}}};
+    MotionCurveTable table;
+
+    TEST_ASSERT_TRUE(table.build(curve));
+    TEST_ASSERT_EQUAL_INT32(50, table.gain(0));
+    TEST_ASSERT_EQUAL_INT32(50, table.gain(V_ONE / 10));
+    TEST_ASSERT_EQUAL_INT32(110, table.gain(3*V_ONE));
+    TEST_ASSERT_EQUAL_INT32(110, table.gain(MOTION_V_MAX));
+}
+
+static void test_default_curves_match_lookup_table(void){
+    for(uint32_t level=0; level<SENSITIVITY_STEP_COUNT; level++){
+        MotionCurveTable table;
+        TEST_ASSERT_TRUE(table.build(MOTION_CURVE_DEFAULT[level]));
+        for(int32_t v=0; v<=V_ONE/5; v+=V_ONE/1000){
+            TEST_ASSERT_INT_WITHIN(2, MotionCurveTable::curveGain(MOTION_CURVE_DEFAULT[level], v), table.gain(v));
+        }
+    }
+}
+
+static void test_invalid_curves_rejected(void){
+    MotionCurve empty = {0, {}};
+    MotionCurve descending = {2, {{500, 10}, {400, 20}}};
+    MotionCurve too_steep = {1, {{100, (uint16_t)(MOTION_CURVE_GAIN_MAX + 1)}}};
+    MotionCurveTable table;
+
+    TEST_ASSERT_FALSE(MotionCurveTable::isValid(empty));
+    TEST_ASSERT_FALSE(MotionCurveTable::isValid(descending));
+    TEST_ASSERT_FALSE(MotionCurveTable::isValid(too_steep));
+    TEST_ASSERT_FALSE(table.build(descending));
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_wide_points_interpolate);
+    RUN_TEST(test_wide_points_monotonic);
+    RUN_TEST(test_gain_constant_outside_points);
+    RUN_TEST(test_default_curves_match_lookup_table);
+    RUN_TEST(test_invalid_curves_rejected);
+    return UNITY_END();
+}
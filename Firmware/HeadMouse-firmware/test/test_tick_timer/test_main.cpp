@@ -0,0 +1,132 @@
+/* TICK TIMER TESTS ******************************************************
+ *
+ * Description: Multiplexing of the channels of TickTimer on one
+ *              simulated hardware timer: periods, dispatch order,
+ *              restart and stop, also from the channel callbacks.
+ *
+ *              Run: pio test -e native -f test_tick_timer
+ *
+ ************************************************************************/
+#include <unity.h>
+#include "tick_timer.hpp"
+#include "host_sim.h"
+
+static constexpr uint32_t TEST_TICK_US = 10000;
+
+static TickTimer timer(0);
+static uint32_t expiries[TICK_CHANNEL_MAX];
+static uint32_t expiry_ticks[TICK_CHANNEL_MAX];    // Tick of the last expiry
+static int dispatch_order[16];
+static uint32_t dispatch_count;
+
+static bool _callbackCount(void* channel){
+    int index = (int)(uintptr_t)channel;
+    expiries[index]++;
+    expiry_ticks[index] = timer.getTicks();
+    if(dispatch_count < 16) dispatch_order[dispatch_count++] = index;
+    return true;
+}
+
+/* One-shot timeout: stops its own channel */
+static bool _callbackOneShot(void* channel){
+    _callbackCount(channel);
+    timer.stopChannel((int)(uintptr_t)channel);
+    return true;
+}
+
+static void _advanceTicks(uint32_t ticks){
+    host::advanceMicros((uint64_t)ticks * TEST_TICK_US);
+}
+
+void setUp(void){
+    TEST_ASSERT_TRUE(timer.begin(TEST_TICK_US));
+    for(uint32_t i=0; i<TICK_CHANNEL_MAX; i++){
+        timer.stopChannel(i);
+        expiries[i] = 0;
+        expiry_ticks[i] = 0;
+    }
+    dispatch_count = 0;
+}
+void tearDown(void){}
+
+/* Every channel expires with its own period on the shared tick */
+static void test_channel_periods(void){
+    uint32_t start = timer.getTicks();
+
+    TEST_ASSERT_TRUE(timer.attachChannel(0, 1, _callbackCount, true));
+    TEST_ASSERT_TRUE(timer.attachChannel(1, 3, _callbackCount, true));
+    TEST_ASSERT_TRUE(timer.attachChannel(2, 5, _callbackCount, true));
+    _advanceTicks(16);
+
+    TEST_ASSERT_EQUAL_UINT32(16, timer.getTicks() - start);
+    /* First expiry after period + 1 ticks, the channels start within a tick */
+    TEST_ASSERT_EQUAL_UINT32(15, expiries[0]);
+    TEST_ASSERT_EQUAL_UINT32(5, expiries[1]);
+    TEST_ASSERT_EQUAL_UINT32(3, expiries[2]);
+    TEST_ASSERT_EQUAL_UINT32(0, expiries[3]);
+    TEST_ASSERT_EQUAL_UINT32(start + 16, expiry_ticks[1]);
+    TEST_ASSERT_EQUAL_UINT32(start + 16, expiry_ticks[2]);
+}
+
+/* Channels expiring on the same tick are dispatched in channel order */
+static void test_dispatch_order(void){
+    TEST_ASSERT_TRUE(timer.attachChannel(3, 2, _callbackCount, true));
+    TEST_ASSERT_TRUE(timer.attachChannel(1, 2, _callbackCount, true));
+    TEST_ASSERT_TRUE(timer.attachChannel(2, 2, _callbackCount, true));
+    _advanceTicks(3);
+
+    TEST_ASSERT_EQUAL_UINT32(3, dispatch_count);
+    TEST_ASSERT_EQUAL_INT(1, dispatch_order[0]);
+    TEST_ASSERT_EQUAL_INT(2, dispatch_order[1]);
+    TEST_ASSERT_EQUAL_INT(3, dispatch_order[2]);
+}
+
+/* A channel restarted before its expiry (debounce) never expires, the others are not affected */
+static void test_restart_postpones_expiry(void){
+    TEST_ASSERT_TRUE(timer.attachChannel(0, 2, _callbackCount, true));
+    TEST_ASSERT_TRUE(timer.attachChannel(1, 3, _callbackCount, false));
+    timer.startChannel(1);
+    for(int i=0; i<10; i++){
+        _advanceTicks(2);
+        timer.startChannel(1);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, expiries[1]);
+    TEST_ASSERT_EQUAL_UINT32(9, expiries[0]);
+
+    _advanceTicks(4);
+    TEST_ASSERT_EQUAL_UINT32(1, expiries[1]);
+}
+
+/* A channel stopping itself from its callback expires once */
+static void test_one_shot(void){
+    TEST_ASSERT_TRUE(timer.attachChannel(2, 4, _callbackOneShot, true));
+    TEST_ASSERT_TRUE(timer.attachChannel(0, 1, _callbackCount, true));
+    _advanceTicks(20);
+    TEST_ASSERT_EQUAL_UINT32(1, expiries[2]);
+    TEST_ASSERT_EQUAL_UINT32(19, expiries[0]);
+
+    timer.startChannel(2);
+    _advanceTicks(5);
+    TEST_ASSERT_EQUAL_UINT32(2, expiries[2]);
+}
+
+static void test_invalid_channels(void){
+    TEST_ASSERT_FALSE(timer.attachChannel(-1, 1, _callbackCount, true));
+    TEST_ASSERT_FALSE(timer.attachChannel(TICK_CHANNEL_MAX, 1, _callbackCount, true));
+    TEST_ASSERT_FALSE(timer.attachChannel(0, 0, _callbackCount, true));
+    TEST_ASSERT_FALSE(timer.attachChannel(0, 1, nullptr, true));
+
+    /* Only one tick timer can run */
+    TickTimer other(1);
+    TEST_ASSERT_FALSE(other.begin(TEST_TICK_US));
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_channel_periods);
+    RUN_TEST(test_dispatch_order);
+    RUN_TEST(test_restart_postpones_expiry);
+    RUN_TEST(test_one_shot);
+    RUN_TEST(test_invalid_channels);
+    return UNITY_END();
+}